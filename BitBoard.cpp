@@ -0,0 +1,222 @@
+#include "BitBoard.h"
+#include "Bits.h"
+
+// Returns a mask of the bit positions where the bit-sliced 'count' equals
+// the bit-sliced 'value'. Each bit position is compared independently.
+static inline uint64_t countEquals(const uint64_t count[4], const uint64_t value[4]) {
+	return ~((count[0] ^ value[0]) | (count[1] ^ value[1]) |
+			 (count[2] ^ value[2]) | (count[3] ^ value[3]));
+}
+
+// Resizes a plane, zeroing it only when the layout changes. Border words are
+// never written while the layout stays the same, so they stay zero across calls.
+static inline void fitPlane(std::vector<uint64_t>& plane, size_t size, bool relayout) {
+	if (relayout || plane.size() != size)
+		plane.assign(size, 0);
+}
+
+BitBoard::BitBoard() : boardWidth(0), boardHeight(0), words(0), stride(2), scratchStride(0) {}
+
+int BitBoard::width() const { return boardWidth; }
+
+int BitBoard::height() const { return boardHeight; }
+
+size_t BitBoard::index(int y, int w) const {
+	return static_cast<size_t>(y + 1) * stride + w + 1;
+}
+
+void BitBoard::load(const std::vector<std::vector<Cell>>& board) {
+	boardHeight = static_cast<int>(board.size());
+	boardWidth = boardHeight ? static_cast<int>(board[0].size()) : 0;
+	words = (boardWidth + 63) / 64;
+	stride = words + 2;
+
+	size_t planeSize = static_cast<size_t>(boardHeight + 2) * stride;
+	unknown.assign(planeSize, 0);
+	flag.assign(planeSize, 0);
+	number.assign(planeSize, 0);
+	for (auto& plane : numberBits)
+		plane.assign(planeSize, 0);
+
+	for (int y = 0; y < boardHeight; ++y) {
+		for (int x = 0; x < boardWidth; ++x) {
+			size_t id = index(y, x / 64);
+			uint64_t bit = 1ULL << (x % 64);
+
+			State state = board[y][x].state;
+			if (state == UNKNOWN)
+				unknown[id] |= bit;
+			else if (state == FLAG)
+				flag[id] |= bit;
+			else if (state >= ONE && state <= EIGHT) {
+				number[id] |= bit;
+				for (int i = 0; i < 4; ++i)
+					if ((state >> i) & 1)
+						numberBits[i][id] |= bit;
+			}
+		}
+	}
+}
+
+void BitBoard::sideSums(const std::vector<uint64_t>& plane, std::vector<uint64_t>& sideOnes,
+	std::vector<uint64_t>& sideTwos) const {
+	for (int y = 0; y < boardHeight; ++y) {
+		for (size_t id = index(y, 0), end = id + words; id < end; ++id) {
+			// Cell x's west neighbor is x - 1, so the row is shifted up by one bit
+			// (carrying in the top bit of the previous word), and vice versa for east.
+			uint64_t west = (plane[id] << 1) | (plane[id - 1] >> 63);
+			uint64_t east = (plane[id] >> 1) | (plane[id + 1] << 63);
+
+			// Half adder over the two.
+			sideOnes[id] = west ^ east;
+			sideTwos[id] = west & east;
+		}
+	}
+}
+
+void BitBoard::spreadSides(const std::vector<uint64_t>& plane, std::vector<uint64_t>& spread) const {
+	for (int y = 0; y < boardHeight; ++y) {
+		for (size_t id = index(y, 0), end = id + words; id < end; ++id) {
+			uint64_t west = (plane[id] << 1) | (plane[id - 1] >> 63);
+			uint64_t east = (plane[id] >> 1) | (plane[id + 1] << 63);
+			spread[id] = west | plane[id] | east;
+		}
+	}
+}
+
+void BitBoard::countNeighbors(const std::vector<uint64_t>& plane, const std::vector<uint64_t>& sideOnes,
+	const std::vector<uint64_t>& sideTwos, size_t id, uint64_t count[4]) const {
+	size_t above = id - stride;
+	size_t below = id + stride;
+
+	// The cell's own row contributes only its west and east neighbors. The rows
+	// above and below also contribute the cell directly above or below, which is
+	// added to their side sums with a second half adder.
+	uint64_t aOnes = sideOnes[above] ^ plane[above];
+	uint64_t aTwos = sideTwos[above] | (sideOnes[above] & plane[above]);
+	uint64_t bOnes = sideOnes[below] ^ plane[below];
+	uint64_t bTwos = sideTwos[below] | (sideOnes[below] & plane[below]);
+	uint64_t mOnes = sideOnes[id];
+	uint64_t mTwos = sideTwos[id];
+
+	// Ones column: three inputs, carry goes into the twos column.
+	uint64_t onesSum = aOnes ^ bOnes ^ mOnes;
+	uint64_t onesCarry = (aOnes & bOnes) | (mOnes & (aOnes ^ bOnes));
+
+	// Twos column: four inputs, carries go into the fours and eights columns.
+	uint64_t twosPartial = aTwos ^ bTwos ^ mTwos;
+	uint64_t twosCarry = (aTwos & bTwos) | (mTwos & (aTwos ^ bTwos));
+	uint64_t twosSum = twosPartial ^ onesCarry;
+	uint64_t foursIn = twosPartial & onesCarry;
+
+	count[0] = onesSum;
+	count[1] = twosSum;
+	count[2] = twosCarry ^ foursIn;
+	count[3] = twosCarry & foursIn;
+}
+
+void BitBoard::findMoves(std::vector<uint64_t>& mines, std::vector<uint64_t>& safe) const {
+	// Two layouts can share a plane size with a different stride, which moves the
+	// border words, so the scratch planes are zeroed whenever the stride changes too.
+	size_t planeSize = unknown.size();
+	bool relayout = scratchStride != stride;
+	scratchStride = stride;
+	for (auto* plane : { &covered, &coveredSideOnes, &coveredSideTwos, &flagSideOnes, &flagSideTwos,
+		&mineSources, &safeSources, &mineSpread, &safeSpread, &mines, &safe })
+		fitPlane(*plane, planeSize, relayout);
+
+	// Covered cells are the ones that can hold a mine: unknown or flagged.
+	for (size_t id = 0; id < planeSize; ++id)
+		covered[id] = unknown[id] | flag[id];
+
+	sideSums(covered, coveredSideOnes, coveredSideTwos);
+	sideSums(flag, flagSideOnes, flagSideTwos);
+
+	// Pass 1: mark the number cells that satisfy either rule. A number equal to
+	// its covered neighbors forces mines, a number equal to its flags forces safe cells.
+	for (int y = 0; y < boardHeight; ++y) {
+		for (size_t id = index(y, 0), end = id + words; id < end; ++id) {
+			uint64_t value[4] = { numberBits[0][id], numberBits[1][id], numberBits[2][id], numberBits[3][id] };
+			uint64_t coveredCount[4], flagCount[4];
+			countNeighbors(covered, coveredSideOnes, coveredSideTwos, id, coveredCount);
+			countNeighbors(flag, flagSideOnes, flagSideTwos, id, flagCount);
+
+			mineSources[id] = number[id] & countEquals(coveredCount, value);
+			safeSources[id] = number[id] & countEquals(flagCount, value);
+		}
+	}
+
+	// Pass 2: every unknown cell next to a marked number cell is forced.
+	spreadSides(mineSources, mineSpread);
+	spreadSides(safeSources, safeSpread);
+	for (int y = 0; y < boardHeight; ++y) {
+		for (size_t id = index(y, 0), end = id + words; id < end; ++id) {
+			mines[id] = (mineSpread[id - stride] | mineSpread[id] | mineSpread[id + stride]) & unknown[id];
+			safe[id] = (safeSpread[id - stride] | safeSpread[id] | safeSpread[id + stride]) & unknown[id];
+		}
+	}
+}
+
+void BitBoard::applyMoves(const std::vector<uint64_t>& mines, const std::vector<uint64_t>& safe) {
+	for (int y = 0; y < boardHeight; ++y) {
+		for (size_t id = index(y, 0), end = id + words; id < end; ++id) {
+			flag[id] |= mines[id];
+			unknown[id] &= ~(mines[id] | safe[id]);
+		}
+	}
+}
+
+void BitBoard::revealNumber(int x, int y, int value) {
+	size_t id = index(y, x / 64);
+	uint64_t bit = 1ULL << (x % 64);
+
+	unknown[id] &= ~bit;
+	flag[id] &= ~bit;
+	number[id] |= bit;
+	for (int i = 0; i < 4; ++i) {
+		if ((value >> i) & 1)
+			numberBits[i][id] |= bit;
+		else
+			numberBits[i][id] &= ~bit;
+	}
+}
+
+State BitBoard::stateAt(int x, int y) const {
+	size_t id = index(y, x / 64);
+	uint64_t bit = 1ULL << (x % 64);
+
+	if (unknown[id] & bit)
+		return UNKNOWN;
+	if (flag[id] & bit)
+		return FLAG;
+	if (!(number[id] & bit))
+		return ZERO;
+
+	int value = 0;
+	for (int i = 0; i < 4; ++i)
+		if (numberBits[i][id] & bit)
+			value |= 1 << i;
+	return static_cast<State>(value);
+}
+
+int BitBoard::countCells(const std::vector<uint64_t>& plane) const {
+	int count = 0;
+	for (int y = 0; y < boardHeight; ++y)
+		for (size_t id = index(y, 0), end = id + words; id < end; ++id)
+			count += countBits(static_cast<uint32_t>(plane[id])) + countBits(static_cast<uint32_t>(plane[id] >> 32));
+	return count;
+}
+
+void BitBoard::collectCells(const std::vector<uint64_t>& plane, std::vector<Coord>& cells) const {
+	for (int y = 0; y < boardHeight; ++y) {
+		for (int w = 0; w < words; ++w) {
+			uint64_t word = plane[index(y, w)];
+			while (word) {
+				int bit = lowestBit(word);
+				word &= word - 1;
+
+				cells.push_back({ static_cast<size_t>(w) * 64 + bit, static_cast<size_t>(y) });
+			}
+		}
+	}
+}
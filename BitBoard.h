@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "BoardParser.h"
+
+// Stores the board as bit planes: one bit per cell, packed into 64-bit words,
+// with every row starting on a new word. Lets the single-cell Minesweeper rules
+// be evaluated for the whole board at once with shifts, ANDs and bit-sliced
+// neighbor counts instead of visiting every cell.
+//
+// Every plane is surrounded by a border of zero words (one row above and below,
+// one word left and right of each row), so neighbor lookups never need bounds checks.
+class BitBoard {
+public:
+	// Constructor. Starts with an empty 0x0 board.
+	BitBoard();
+
+	// Rebuilds every plane from a parsed grid of cells.
+	void load(const std::vector<std::vector<Cell>>& board);
+
+	// Applies both single-cell rules to every number cell at once.
+	// 'mines' receives every unknown cell that must be a mine, 'safe' every
+	// unknown cell that must be safe. Both use the same layout as the planes.
+	void findMoves(std::vector<uint64_t>& mines, std::vector<uint64_t>& safe) const;
+
+	// Applies moves found by findMoves() to the planes as if they had been clicked:
+	// every cell in 'mines' becomes a flag, and every cell in 'safe' stops being
+	// unknown. A revealed cell's number isn't known until the next capture, so
+	// safe cells become neither numbers nor flags, which is still enough for
+	// findMoves() to count them as not being mines.
+	void applyMoves(const std::vector<uint64_t>& mines, const std::vector<uint64_t>& safe);
+
+	// Reveals cell (x, y) as a number, for trying out what clicking it could show.
+	// A zero is stored as a number with no mines around it, so findMoves() marks
+	// its neighbors safe, which is what opening it on screen does.
+	void revealNumber(int x, int y, int value);
+
+	// Returns the state of cell (x, y) as far as the planes know it. Numbers read
+	// as their value, and cells applyMoves() marked safe read as ZERO.
+	State stateAt(int x, int y) const;
+
+	// Returns the number of set cells in 'plane'.
+	int countCells(const std::vector<uint64_t>& plane) const;
+
+	// Appends the coordinates of every set cell in 'plane' to 'cells', in row-major order.
+	void collectCells(const std::vector<uint64_t>& plane, std::vector<Coord>& cells) const;
+
+	int width() const;		// Number of cells horizontally.
+	int height() const;		// Number of cells vertically.
+
+private:
+	int boardWidth;		// Number of cells horizontally.
+	int boardHeight;	// Number of cells vertically.
+	int words;			// Number of 64-bit words needed for one row of cells.
+	int stride;			// Distance between two rows in a plane, including the border words.
+
+	std::vector<uint64_t> unknown;						// Unrevealed, unflagged cells.
+	std::vector<uint64_t> flag;							// Flagged cells.
+	std::vector<uint64_t> number;						// Revealed cells showing 1 through 8.
+	std::array<std::vector<uint64_t>, 4> numberBits;	// Bit-sliced value of each number cell; numberBits[i] holds bit i.
+
+	// Scratch planes used by findMoves(), kept between calls so it doesn't allocate.
+	mutable std::vector<uint64_t> covered;			// Unknown or flagged cells.
+	mutable std::vector<uint64_t> coveredSideOnes;	// Side sums of 'covered', see sideSums().
+	mutable std::vector<uint64_t> coveredSideTwos;
+	mutable std::vector<uint64_t> flagSideOnes;		// Side sums of 'flag', see sideSums().
+	mutable std::vector<uint64_t> flagSideTwos;
+	mutable std::vector<uint64_t> mineSources;		// Number cells whose unknown neighbors are all mines.
+	mutable std::vector<uint64_t> safeSources;		// Number cells whose unknown neighbors are all safe.
+	mutable std::vector<uint64_t> mineSpread;		// 'mineSources' spread to the west and east, see spreadSides().
+	mutable std::vector<uint64_t> safeSpread;		// 'safeSources' spread to the west and east, see spreadSides().
+	mutable int scratchStride;						// Stride the scratch planes were last zeroed for.
+
+	// Index of word 'w' of row 'y' in a plane.
+	size_t index(int y, int w) const;
+
+	// Sums the west and east neighbors of every cell in 'plane' into a 2-bit
+	// bit-sliced counter, split into a ones plane and a twos plane.
+	void sideSums(const std::vector<uint64_t>& plane, std::vector<uint64_t>& sideOnes,
+		std::vector<uint64_t>& sideTwos) const;
+
+	// Marks every cell in 'plane' along with its west and east neighbors.
+	void spreadSides(const std::vector<uint64_t>& plane, std::vector<uint64_t>& spread) const;
+
+	// Counts the set neighbors of the 64 cells in word 'id' of 'plane' into a 4-bit
+	// bit-sliced counter: count[i] holds bit i of every cell's count. Reuses the
+	// side sums of 'plane' so each row is shifted only once.
+	void countNeighbors(const std::vector<uint64_t>& plane, const std::vector<uint64_t>& sideOnes,
+		const std::vector<uint64_t>& sideTwos, size_t id, uint64_t count[4]) const;
+};
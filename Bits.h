@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Wrappers around the bit scan and population count intrinsics, so the
+// parser and solver also build with GCC and Clang for offline replay.
+
+// Returns the index of the lowest set bit in 'word'. 'word' must not be zero.
+inline int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+// Returns the number of set bits in 'word'.
+inline int countBits(uint32_t word) {
+#ifdef _MSC_VER
+	return static_cast<int>(__popcnt(word));
+#else
+	return __builtin_popcount(word);
+#endif
+}
@@ -1,6 +1,6 @@
 #include "BoardImage.h"
 
-Pixel BoardImage::getPixel(int id) const {
+Pixel BoardImage::getPixel(size_t id) const {
 	return { pixels[id + 2], pixels[id + 1], pixels[id] };
 }
 
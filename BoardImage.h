@@ -1,8 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
 #include <vector>
-#include <windows.h>
 
 // Represents the color of a pixel in RGB
 struct Pixel {
@@ -14,13 +14,13 @@ struct Pixel {
 // Provides helper functions to get a pixel from the raw pixel bytes and compare two pixel colors.
 class BoardImage {
 public:
-	std::vector<BYTE> pixels;	// Raw pixel bytes in BGRA format.
+	std::vector<uint8_t> pixels;	// Raw pixel bytes in BGRA format.
 	int width;					// Width of the captured board in pixels.
 	int	height;					// Height of the captured board in pixels.
 	int	cellWidth;				// Width of a single Minesweeper cell in pixels.
 
 	// Returns a Pixel struct in RGB of the pixel at the given index in the pixels vector.
-	Pixel getPixel(int id) const;
+	Pixel getPixel(size_t id) const;
 
 	// Compares a pixel to a target color. Returns true if each
 	// pixel value is within tolerance of the target's cooresponding value.
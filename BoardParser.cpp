@@ -1,45 +1,138 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "BoardParser.h"
+#include "Bits.h"
 
-BoardParser::BoardParser() {}
+// Width and height of a tile in cells.
+static const int tileSize = 32;
+
+// Boards with fewer cells are never split across threads; starting the
+// threads would cost more than the work they take over.
+static const size_t parallelCells = 16384;
+
+// Returns true if the state is a revealed number, one through eight.
+static bool isNumber(State state) {
+	return state >= ONE && state <= EIGHT;
+}
+
+BoardParser::BoardParser() : img(nullptr), front(0), boardWidth(0), boardHeight(0), tileColumns(0), tileRows(0) {
+	workers = std::max(1u, std::thread::hardware_concurrency());
+}
 
 void BoardParser::update(const BoardImage& image) {
-	img = image;
+	img = &image;
+
+	boardWidth = img->width / img->cellWidth;
+	boardHeight = img->height / img->cellWidth;
+}
+
+const std::vector<std::vector<Cell>>& BoardParser::returnBoard() const { return parsedBoards[front]; }
+
+const std::vector<BoardTile>& BoardParser::returnTiles() const { return tiles[front]; }
+
+std::vector<std::vector<Cell>>& BoardParser::backBoard() {
+	int back = 1 - front;
+	auto& board = parsedBoards[back];
+	tileColumns = (boardWidth + tileSize - 1) / tileSize;
+	tileRows = (boardHeight + tileSize - 1) / tileSize;
+
+	if (board.size() != boardHeight || (boardHeight > 0 && board[0].size() != boardWidth)) {
+		board.assign(boardHeight, std::vector<Cell>(boardWidth));
+		for (size_t y = 0; y < boardHeight; ++y) {
+			for (size_t x = 0; x < boardWidth; ++x) {
+				Cell& cell = board[y][x];
+				cell = { NOTFOUND, 0, 0, x, y, {} };
+			}
+		}
+		tiles[back].assign(static_cast<size_t>(tileColumns) * tileRows, BoardTile());
+		dirtyTiles[back].assign(static_cast<size_t>(tileColumns) * tileRows, 1);
+	}
+	return board;
+}
+
+void BoardParser::setState(size_t x, size_t y, State state) {
+	int back = 1 - front;
+	Cell& cell = parsedBoards[back][y][x];
+	if (cell.state == state)
+		return;
+
+	cell.state = state;
+	dirtyTiles[back][(y / tileSize) * tileColumns + x / tileSize] = 1;
+}
+
+void BoardParser::forEachBand(const std::function<void(int first, int last)>& work) {
+	size_t cells = static_cast<size_t>(boardWidth) * boardHeight;
+	int bands = static_cast<int>(std::min<unsigned>(workers, tileRows));
+	if (bands <= 1 || cells < parallelCells) {
+		work(0, tileRows);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for (int band = 1; band < bands; ++band)
+		threads.emplace_back(work, tileRows * band / bands, tileRows * (band + 1) / bands);
+	work(0, tileRows / bands);
+	for (auto& thread : threads)
+		thread.join();
+}
+
+// The color of every state the parser recognizes.
+static const std::pair<Pixel, State> stateColors[] = {
+	{{ 222, 189, 156 }, ZERO},
+	{{ 25, 118, 210 }, ONE},
+	{{ 56, 142, 60 }, TWO},
+	{{ 211, 47, 47 }, THREE},
+	{{ 123, 31, 162 }, FOUR},
+	{{ 255, 143, 0 }, FIVE},
+	{{ 0, 151, 167 }, SIX},
+	{{ 66, 66, 66 }, SEVEN},
+	{{ 230, 51, 7 }, FLAG},
+	{{ 166, 212, 77 }, UNKNOWN},
+};
+static const int colorCount = sizeof(stateColors) / sizeof(stateColors[0]);
+static const int colorTolerance = 10;
 
-	boardWidth = img.width / img.cellWidth;
-	boardHeight = img.height / img.cellWidth;
+// Index of the 8x8x8 block of RGB space holding a color.
+static int colorBlock(int r, int g, int b) {
+	return ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
 }
 
-const std::vector<std::vector<Cell>>& BoardParser::returnBoard() const { return parsedBoard; }
-
-State BoardParser::findState(const Pixel& pixel) {
-	static const std::vector<std::pair<Pixel, State>> lookup = {
-		{{ 222, 189, 156 }, ZERO},
-		{{ 25, 118, 210 }, ONE},
-		{{ 56, 142, 60 }, TWO},
-		{{ 211, 47, 47 }, THREE},
-		{{ 123, 31, 162 }, FOUR},
-		{{ 255, 143, 0 }, FIVE},
-		{{ 0, 151, 167 }, SIX},
-		{{ 66, 66, 66 }, SEVEN},
-		{{ 230, 51, 7 }, FLAG},
-		{{ 166, 212, 77 }, UNKNOWN},
-	};
-
-	for (const auto& [p, state] : lookup) {
-		if (img.matchColor(p, pixel, 10))
+// For every block of RGB space, a bitmask of the 'stateColors' entries within
+// tolerance of some color in it. A pixel then only has to be compared with the
+// one or two colors near it instead of all of them.
+static std::vector<uint16_t> makeColorBlocks() {
+	std::vector<uint16_t> blocks(1 << 15, 0);
+	for (int i = 0; i < colorCount; ++i) {
+		const Pixel& color = stateColors[i].first;
+		for (int r = std::max(color.r - colorTolerance, 0); r <= std::min(color.r + colorTolerance, 255); ++r)
+			for (int g = std::max(color.g - colorTolerance, 0); g <= std::min(color.g + colorTolerance, 255); ++g)
+				for (int b = std::max(color.b - colorTolerance, 0); b <= std::min(color.b + colorTolerance, 255); ++b)
+					blocks[colorBlock(r, g, b)] |= 1 << i;
+	}
+	return blocks;
+}
+
+State BoardParser::findState(const Pixel& pixel) const {
+	static const std::vector<uint16_t> blocks = makeColorBlocks();
+
+	// Candidates are checked in table order, like a plain scan would.
+	for (uint32_t mask = blocks[colorBlock(pixel.r, pixel.g, pixel.b)]; mask; mask &= mask - 1) {
+		const auto& [p, state] = stateColors[lowestBit(mask)];
+		if (img->matchColor(p, pixel, colorTolerance))
 			return state;
 	}
 	return NOTFOUND;
 }
 
-Cell BoardParser::makeCell(size_t start, size_t x, size_t y) {
+State BoardParser::readCell(size_t start) const {
 	bool zero = false;
 	bool unknown = false;
 
-	for (size_t id = 0; id < img.cellWidth; ++id) {
+	for (size_t id = 0; id < img->cellWidth; ++id) {
 		size_t scaledid = (id + start) * 4;
 
-		Pixel pixel = img.getPixel(scaledid);
+		Pixel pixel = img->getPixel(scaledid);
 		State state = findState(pixel);
 
 		if (state == ZERO)
@@ -47,63 +140,145 @@ Cell BoardParser::makeCell(size_t start, size_t x, size_t y) {
 		else if (state == UNKNOWN)
 			unknown = true;
 		else if (!(state == NOTFOUND))
-			return { state, 0, 0, x, y, {} };
+			return state;
 	}
 	if (zero)
-		return { ZERO, 0, 0, x, y, {} };
+		return ZERO;
 	else if (unknown)
-		return { UNKNOWN, 0, 0, x, y, {} };
+		return UNKNOWN;
 	else
-		return { NOTFOUND, 0, 0, x, y, {} };
+		return NOTFOUND;
 }
 
 void BoardParser::parseCells() {	
-	static bool firstTime = true;
-	if (firstTime) {
-		firstTime = false;
-		parsedBoard.resize(boardHeight);
-		for (auto& row : parsedBoard)
-			row.resize(boardWidth);
-	}
+	backBoard();
 
-	for (size_t y = 0; y < boardHeight; ++y) {
-		for (size_t x = 0; x < boardWidth; ++x) {
-			size_t id = img.cellWidth * (y * img.width + img.width / 2 + x);
-			Cell cell = makeCell(id, x, y);
-			if (cell.state == NOTFOUND) {
-				gameOver = true;
+	// Every band owns whole tiles, so bands never mark the same dirty flag.
+	std::atomic<bool> failed(false);
+	forEachBand([&](int first, int last) {
+		size_t end = std::min<size_t>(static_cast<size_t>(last) * tileSize, boardHeight);
+		for (size_t y = static_cast<size_t>(first) * tileSize; y < end; ++y) {
+			if (failed)
 				return;
+			for (size_t x = 0; x < boardWidth; ++x) {
+				size_t id = img->cellWidth * (y * img->width + img->width / 2 + x);
+				State state = readCell(id);
+				if (state == NOTFOUND) {
+					failed = true;
+					return;
+				}
+				setState(x, y, state);
 			}
-			parsedBoard[y][x] = cell;
 		}
-	}
+	});
+
+	if (failed)
+		gameOver = true;
 }
 
-void BoardParser::initParsedBoard() {
-	for (auto& row : parsedBoard) {
-		for (auto& cell : row) {
-			if (cell.state == FLAG || cell.state == UNKNOWN || cell.state == ZERO)
+void BoardParser::loadStates(const std::vector<uint8_t>& states, int width, int height) {
+	boardWidth = width;
+	boardHeight = height;
+
+	backBoard();
+	for (size_t y = 0; y < boardHeight; ++y)
+		for (size_t x = 0; x < boardWidth; ++x)
+			setState(x, y, static_cast<State>(states[y * boardWidth + x]));
+}
+
+void BoardParser::applyFlags(const std::vector<Coord>& flags) {
+	const auto& current = parsedBoards[front];
+	backBoard();
+	for (size_t y = 0; y < boardHeight; ++y)
+		for (size_t x = 0; x < boardWidth; ++x)
+			setState(x, y, current[y][x].state);
+
+	for (const auto& coord : flags)
+		setState(coord.x, coord.y, FLAG);
+
+	initParsedBoard();
+}
+
+void BoardParser::rebuildTile(int tx, int ty) {
+	int back = 1 - front;
+	auto& parsedBoard = parsedBoards[back];
+	BoardTile& tile = tiles[back][static_cast<size_t>(ty) * tileColumns + tx];
+	tile.frontier.clear();
+	tile.numbers.clear();
+
+	int endY = std::min((ty + 1) * tileSize, boardHeight);
+	int endX = std::min((tx + 1) * tileSize, boardWidth);
+	for (int y = ty * tileSize; y < endY; ++y) {
+		for (int x = tx * tileSize; x < endX; ++x) {
+			Cell& cell = parsedBoard[y][x];
+			cell.adjacentFlags = 0;
+			cell.adjacentUnknowns = 0;
+			cell.neighbors.clear();
+			cell.frontier = false;
+
+			// Each cell only reads its neighbors, so tiles can be rebuilt
+			// independently. Numbers collect their unknown neighbors and flags,
+			// and unknown cells next to a number are on the frontier.
+			bool number = isNumber(cell.state);
+			if (!number && cell.state != UNKNOWN)
 				continue;
 
-			for (int x = -1; x < 2; ++x) {
-				for (int y = -1; y < 2; ++y) {
-					size_t nx = cell.x + x;
-					size_t ny = cell.y + y;
+			for (int dx = -1; dx < 2; ++dx) {
+				for (int dy = -1; dy < 2; ++dy) {
+					int nx = x + dx;
+					int ny = y + dy;
 					if (nx < 0 || nx >= boardWidth ||
 						ny < 0 || ny >= boardHeight)
 						continue;
 
 					const auto& neighbor = parsedBoard[ny][nx];
 
+					if (!number) {
+						if (isNumber(neighbor.state))
+							cell.frontier = true;
+						continue;
+					}
 					if (neighbor.state == UNKNOWN) {
 						cell.adjacentUnknowns += 1;
-						cell.neighbors.push_back({ nx, ny });
-						parsedBoard[ny][nx].frontier = true;
+						cell.neighbors.push_back({ static_cast<size_t>(nx), static_cast<size_t>(ny) });
 					}
 					if (neighbor.state == FLAG) 
 						cell.adjacentFlags += 1;
 				}
 			}
+
+			if (cell.frontier)
+				tile.frontier.push_back({ static_cast<size_t>(x), static_cast<size_t>(y) });
+			if (number && cell.adjacentUnknowns > 0)
+				tile.numbers.push_back({ static_cast<size_t>(x), static_cast<size_t>(y) });
 		}
 	}
-}
\ No newline at end of file
+}
+
+void BoardParser::initParsedBoard() {
+	int back = 1 - front;
+	const auto& dirty = dirtyTiles[back];
+
+	// Cells on a tile's edge read the cells across it, so a tile is
+	// stale if it or any tile around it changed.
+	staleTiles.assign(dirty.size(), 0);
+	for (int ty = 0; ty < tileRows; ++ty) {
+		for (int tx = 0; tx < tileColumns; ++tx) {
+			if (!dirty[static_cast<size_t>(ty) * tileColumns + tx])
+				continue;
+			for (int ny = std::max(ty - 1, 0); ny <= std::min(ty + 1, tileRows - 1); ++ny)
+				for (int nx = std::max(tx - 1, 0); nx <= std::min(tx + 1, tileColumns - 1); ++nx)
+					staleTiles[static_cast<size_t>(ny) * tileColumns + nx] = 1;
+		}
+	}
+
+	forEachBand([&](int first, int last) {
+		for (int ty = first; ty < last; ++ty)
+			for (int tx = 0; tx < tileColumns; ++tx)
+				if (staleTiles[static_cast<size_t>(ty) * tileColumns + tx])
+					rebuildTile(tx, ty);
+	});
+
+	std::fill(dirtyTiles[back].begin(), dirtyTiles[back].end(), 0);
+	front = back;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include "BoardImage.h"
 
@@ -32,7 +34,7 @@ struct Coord {
 // For coord use in unordered maps.
 struct CoordHash {
 	std::size_t operator()(const Coord& c) const {
-		return std::hash<int>()(c.x) ^ (std::hash<int>()(c.y) << 1);
+		return std::hash<size_t>()(c.x) ^ (std::hash<size_t>()(c.y) << 1);
 	}
 };
 
@@ -48,38 +50,92 @@ struct Cell {
 	bool frontier = false;
 };
 
+// The cells of one square tile of the parsed grid that the solver's
+// constraint satisfaction looks at, so it can skip every other cell.
+struct BoardTile {
+	std::vector<Coord> frontier;	// Unknown cells next to a number, row-major.
+	std::vector<Coord> numbers;		// Number cells with at least one unknown neighbor, row-major.
+};
+
 // Parses a board image into a grid of cells useable by the solver.
+// Parsed grids are double-buffered: a new grid is built in the back buffer while
+// the last complete one stays readable, and finishing a grid just swaps the two.
+// Cells are overwritten in place, so after the first few turns nothing is copied
+// or allocated per turn.
+//
+// Each grid is split into square tiles. A tile whose cells didn't change since
+// its grid was last built, and whose neighboring tiles didn't either, keeps its
+// adjacency and neighbor data, so a turn only rebuilds the area around its clicks.
+// Large boards are parsed and built in bands of tile rows on several threads.
 class BoardParser {
 public:
-	// Constructor. Doesn't initialize anything.
+	// Constructor. Starts with no image and empty grids, and with one worker per hardware thread.
 	BoardParser();
 
-	// Updates the board image with a newly captured one.
+	// Points the parser at a newly captured image. The image is read in place,
+	// not copied, so it must stay alive and unchanged until parseCells() returns.
 	void update(const BoardImage& img);
 
-	// Returns the parsed grid of cells.
+	// Returns the last completely parsed grid of cells, i.e. the one
+	// finished by the last call to initParsedBoard().
 	const std::vector<std::vector<Cell>>& returnBoard() const;
 
-	// Reads the board image into a grid of cells with states and coordinates,
-	// leaving adjacency and neighbor data as zero or empty.
+	// Returns the tiles of the grid returned by returnBoard(), row-major.
+	const std::vector<BoardTile>& returnTiles() const;
+
+	// Reads the board image into the back grid of cells, marking the tiles
+	// whose states changed for initParsedBoard() to rebuild.
 	void parseCells();
 
-	// Fills in adjacency and neighbor data for each cell in a newly parsed grid.
+	// Builds the grid of cells straight from a row-major list of states, for replaying
+	// recorded games without a board image. Like parseCells(), leaves adjacency and
+	// neighbor data to initParsedBoard().
+	void loadStates(const std::vector<uint8_t>& states, int width, int height);
+
+	// Fills in adjacency and neighbor data for each cell in the tiles that changed
+	// in a newly parsed grid, then makes it the grid returned by returnBoard().
 	void initParsedBoard();
 
+	// Builds the next grid from the current one with every cell in 'flags' flagged,
+	// without a board image. Flagging never reveals anything, so after a turn that
+	// only placed flags this matches what a capture would show. Calls initParsedBoard() itself.
+	void applyFlags(const std::vector<Coord>& flags);
+
 	bool gameOver = false;
+	unsigned workers;	// Threads that large boards are split across; 1 keeps all work on the calling thread.
 
 private:
-	BoardImage img;								// Current captured board image.
-	std::vector<std::vector<Cell>> parsedBoard;	// Parsed grid of cell data.
-	int boardWidth;								// Number of cells horizontally.
-	int boardHeight;							// Number of cells vertically.
+	const BoardImage* img;							// Current captured board image, owned by the capture stage.
+	std::vector<std::vector<Cell>> parsedBoards[2];	// Double-buffered grids of cell data.
+	std::vector<BoardTile> tiles[2];				// Tiles of each grid, row-major.
+	std::vector<uint8_t> dirtyTiles[2];				// Tiles of each grid whose states changed since it was built.
+	std::vector<uint8_t> staleTiles;				// Tiles initParsedBoard() rebuilds: dirty, or next to a dirty tile.
+	int front;										// Index of the grid returned by returnBoard().
+	int boardWidth;									// Number of cells horizontally.
+	int boardHeight;								// Number of cells vertically.
+	int tileColumns;								// Number of tiles horizontally.
+	int tileRows;									// Number of tiles vertically.
+
+	// Returns the grid being built. If the board size changed, resizes it
+	// and marks every tile dirty.
+	std::vector<std::vector<Cell>>& backBoard();
+
+	// Sets the state of a cell in the grid being built, marking its tile dirty if it changed.
+	void setState(size_t x, size_t y, State state);
+
+	// Runs 'work' over bands of tile rows [first, last) covering the whole grid,
+	// spread across 'workers' threads if the board is large enough to be worth it.
+	void forEachBand(const std::function<void(int first, int last)>& work);
+
+	// Recomputes adjacency, neighbor and frontier data for every cell of tile
+	// (tx, ty) in the grid being built, along with the tile's cell lists.
+	void rebuildTile(int tx, int ty);
 
 	// Helper function to convert a pixel color into a state;
 	// each state has a unique color.
-	State findState(const Pixel& pixel);
+	State findState(const Pixel& pixel) const;
 
-	// Creates a cell object by iterating through the pixel data for
-	// a single board cell in the board image.
-	Cell makeCell(size_t start, size_t x, size_t y);
-};
\ No newline at end of file
+	// Finds the state of a single board cell by iterating through
+	// its pixel data in the board image.
+	State readCell(size_t start) const;
+};
@@ -3,35 +3,43 @@
 CaptureBoard::CaptureBoard() {
 	left = GetSystemMetrics(SM_XVIRTUALSCREEN);
 	top = GetSystemMetrics(SM_YVIRTUALSCREEN);
-	img.width = GetSystemMetrics(SM_CXVIRTUALSCREEN);
-	img.height = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+	width = GetSystemMetrics(SM_CXVIRTUALSCREEN);
+	height = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+	cellWidth = 0;
 
-	screenWidth = img.width;
+	screenWidth = width;
 }
 
-const BoardImage& CaptureBoard::returnImg() const { return img; }
+const BoardImage& CaptureBoard::returnImg() const { return frames.latest(); }
 
 void CaptureBoard::captureScreen() {
 	HDC hScreenDC = GetDC(NULL);
 	HDC hMemDC = CreateCompatibleDC(hScreenDC);
 
-	HBITMAP hBitmap = CreateCompatibleBitmap(hScreenDC, img.width, img.height);
+	HBITMAP hBitmap = CreateCompatibleBitmap(hScreenDC, width, height);
 	SelectObject(hMemDC, hBitmap);
 
-	BitBlt(hMemDC, 0, 0, img.width, img.height, hScreenDC, left, top, SRCCOPY);
+	BitBlt(hMemDC, 0, 0, width, height, hScreenDC, left, top, SRCCOPY);
 
 	BITMAPINFO bmi = {};
 	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-	bmi.bmiHeader.biWidth = img.width;
-	bmi.bmiHeader.biHeight = -img.height;
+	bmi.bmiHeader.biWidth = width;
+	bmi.bmiHeader.biHeight = -height;
 	bmi.bmiHeader.biPlanes = 1;
 	bmi.bmiHeader.biBitCount = 32;
 	bmi.bmiHeader.biCompression = BI_RGB;
 
-	img.pixels.resize(img.width * img.height * 4);
-	GetDIBits(hMemDC, hBitmap, 0, img.height, img.pixels.data(), &bmi, DIB_RGB_COLORS);
+	// The slot keeps its storage from earlier captures, so this only
+	// allocates the first few times.
+	BoardImage& frame = frames.acquire();
+	frame.width = width;
+	frame.height = height;
+	frame.cellWidth = cellWidth;
+	frame.pixels.resize(width * height * 4);
+	GetDIBits(hMemDC, hBitmap, 0, height, frame.pixels.data(), &bmi, DIB_RGB_COLORS);
+	frames.publish();
 
-	screenWidth = img.width;
+	screenWidth = width;
 
 	DeleteObject(hBitmap);
 	DeleteDC(hMemDC);
@@ -39,6 +47,8 @@ void CaptureBoard::captureScreen() {
 }
 
 void CaptureBoard::findBoard() {
+	const BoardImage& img = frames.latest();
+
 	Pixel target = { 166, 212, 77 };
 	int tolerance = 10;
 	int pixelCount = img.pixels.size() / 4;
@@ -62,7 +72,7 @@ void CaptureBoard::findBoard() {
 		if (!img.matchColor(target, pixel, tolerance))
 			break;
 	}
-	img.width = x - left;
+	width = x - left;
 
 	size_t y;
 	for (y = top; y < pixelCount; ++y) {
@@ -72,7 +82,7 @@ void CaptureBoard::findBoard() {
 		if (!img.matchColor(target, pixel, tolerance))
 			break;
 	}
-	img.height = y - top;
+	height = y - top;
 
 	size_t sid = (top * screenWidth + left) * 4;
 	target = { (img.pixels[sid + 2]), (img.pixels[sid + 1]), (img.pixels[sid]) };
@@ -83,7 +93,7 @@ void CaptureBoard::findBoard() {
 		if (!img.matchColor(target, pixel, 0))
 			break;
 	}
-	img.cellWidth = x;
+	cellWidth = x;
 
 	left += GetSystemMetrics(SM_XVIRTUALSCREEN);
 }
@@ -130,16 +140,16 @@ void CaptureBoard::clickCell(int screenX, int screenY, ActionType action) const
 }
 
 void CaptureBoard::startGame() const {
-	int screenX = left + img.width / 2;
-	int screenY = top + img.height / 2;
+	int screenX = left + width / 2;
+	int screenY = top + height / 2;
 
 	clickCell(screenX, screenY, LCLICK);
 }
 
 void CaptureBoard::applyActions(const std::vector<GridAction>& actions) const {
 	for (const auto& action : actions) {
-		int screenX = left + action.x * img.cellWidth + img.cellWidth / 2;
-		int screenY = top + action.y * img.cellWidth + img.cellWidth / 2;
+		int screenX = left + action.x * cellWidth + cellWidth / 2;
+		int screenY = top + action.y * cellWidth + cellWidth / 2;
 
 		clickCell(screenX, screenY, action.type);
 	}
@@ -2,6 +2,7 @@
 
 #include <windows.h>
 #include "BoardImage.h"
+#include "FrameRing.h"
 #include "Solver.h"
 
 // Handles all interaction with the Minesweeper board on screen, including:
@@ -15,16 +16,16 @@ public:
 	// captureScreen() is called it captures the entire screen.
 	CaptureBoard();
 
-	// Returns the board image.
+	// Returns the latest captured board image.
 	const BoardImage& returnImg() const;
 
-	// Captures a rectangle of the screen into a vector of pixel bytes.
-	// Uses dimensions from BoardImage img, which are initialized to be 
-	// the screen dimensions.
+	// Captures a rectangle of the screen straight into the next frame buffer
+	// of the ring, then publishes it as the latest image. Uses the capture
+	// dimensions, which are initialized to be the screen dimensions.
 	void captureScreen();
 
-	// Finds the minesweeper board in a pixel vector containing the entire screen.
-	// Changes the dimensions of BoardImage img so that whenever captureScreen()
+	// Finds the minesweeper board in the latest image, which must contain the entire
+	// screen. Changes the capture dimensions so that whenever captureScreen()
 	// is called, it captures just the Minesweeper board.
 	void findBoard();
 
@@ -35,9 +36,12 @@ public:
 	void applyActions(const std::vector<GridAction>& actions) const;
 
 private:
-	BoardImage img;		// Data about the board capture, including vector of raw pixel bytes, width, height, and cell width.
+	FrameRing frames;	// Preallocated buffers the screen is captured into.
 	int left;			// X coordinate of the top-leftmost cell of the Minesweeper board.
 	int top;			// Y coordinate of the top-leftmost cell of the Minesweeper board.
+	int width;			// Width of the next capture in pixels.
+	int height;			// Height of the next capture in pixels.
+	int cellWidth;		// Width of a single Minesweeper cell in pixels, once the board is found.
 	int	screenWidth;	// Width of the capture in pixels.
 	
 	// Sets the cursor position to (x, y)
@@ -0,0 +1,22 @@
+#include "FrameRing.h"
+
+FrameRing::FrameRing(size_t slots) : frames(slots < 2 ? 2 : slots), next(0), newest(0) {
+	for (auto& frame : frames) {
+		frame.width = 0;
+		frame.height = 0;
+		frame.cellWidth = 0;
+	}
+}
+
+BoardImage& FrameRing::acquire() {
+	if (next == newest && frames.size() > 1)
+		next = (next + 1) % frames.size();
+	return frames[next];
+}
+
+void FrameRing::publish() {
+	newest = next;
+	next = (next + 1) % frames.size();
+}
+
+const BoardImage& FrameRing::latest() const { return frames[newest]; }
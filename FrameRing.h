@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include "BoardImage.h"
+
+// A fixed ring of preallocated frame buffers shared by the capture, parse and
+// solve stages. The capture stage fills the slot returned by acquire() in place
+// and publishes it; later stages read the latest published frame by reference.
+// Slots keep their pixel storage between captures, so once the ring is warm a
+// capture neither allocates nor copies a frame.
+class FrameRing {
+public:
+	// Constructs a ring with 'slots' frame buffers. Needs at least two, so the
+	// frame being filled is never the one being read.
+	explicit FrameRing(size_t slots = 3);
+
+	// Returns the next slot to fill. It is never the latest published frame.
+	BoardImage& acquire();
+
+	// Marks the slot returned by the last acquire() as the latest frame.
+	void publish();
+
+	// Returns the latest published frame.
+	const BoardImage& latest() const;
+
+private:
+	std::vector<BoardImage> frames;	// Frame buffers, reused in order.
+	size_t next;					// Slot that acquire() returns next.
+	size_t newest;					// Slot of the latest published frame.
+};
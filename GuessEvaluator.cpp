@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "GuessEvaluator.h"
+#include "Solver.h"
+
+// Mine density assumed when there is nothing to estimate it from;
+// about that of Google's hard board.
+static const double defaultDensity = 0.2;
+
+// Reveals nothing, just runs the single-cell rules on 'board' round after
+// round like a speculating solveStep(), and returns how many moves they force.
+static int countForced(BitBoard& board) {
+	std::vector<uint64_t> mines, safe;
+	int forced = 0;
+	while (true) {
+		board.findMoves(mines, safe);
+		int found = board.countCells(mines) + board.countCells(safe);
+		if (found == 0)
+			return forced;
+		forced += found;
+		board.applyMoves(mines, safe);
+	}
+}
+
+// Adds the distribution 'other' of a count independent of 'dist' to it, so
+// 'dist' becomes the distribution of the sum. Counts above 8 are dropped.
+static void convolve(std::vector<double>& dist, const std::vector<double>& other) {
+	std::vector<double> sum(dist.size(), 0);
+	for (size_t a = 0; a < dist.size(); ++a)
+		for (size_t b = 0; a + b < sum.size() && b < other.size(); ++b)
+			sum[a + b] += dist[a] * other[b];
+	dist = sum;
+}
+
+GuessEvaluator::GuessEvaluator() : lookahead(true), maxCandidates(8), chanceSlack(0.02), outsideCandidates(8),
+	timedOut(false) {
+	workers = std::max(1u, std::thread::hardware_concurrency());
+}
+
+const std::vector<GuessCandidate>& GuessEvaluator::returnCandidates() const { return candidates; }
+
+double GuessEvaluator::collectCandidates(const BitBoard& board, const std::vector<SectionCache>& sections, int totalMines) {
+	candidates.clear();
+	int width = board.width();
+	int height = board.height();
+	cellBits.assign(static_cast<size_t>(width) * height, { -1, -1 });
+
+	int frontierCells = 0;
+	double frontierMines = 0;
+	for (int sid = 0; sid < sections.size(); ++sid) {
+		const SectionCache& section = sections[sid];
+		if (section.solutions.empty())
+			continue;
+
+		std::vector<int> mineCount(section.vars.size(), 0);
+		for (uint32_t solution : section.solutions)
+			for (int bit = 0; bit < section.vars.size(); ++bit)
+				mineCount[bit] += (solution >> bit) & 1u;
+
+		for (int bit = 0; bit < section.vars.size(); ++bit) {
+			const Coord& cell = section.vars[bit];
+			double chance = static_cast<double>(mineCount[bit]) / section.solutions.size();
+			cellBits[cell.y * width + cell.x] = { sid, bit };
+			candidates.push_back({ cell, chance, 0, false });
+			frontierCells++;
+			frontierMines += chance;
+		}
+	}
+
+	// Every unknown cell outside the sections is equally likely to be a mine, but
+	// not equally useful. Corners have the fewest neighbors and so open up the
+	// most often, and cells next to a section narrow it down. Up to
+	// 'outsideCandidates' of those are kept, a corner first if there is one,
+	// and the first such cell otherwise.
+	int outsideCells = 0;
+	int flags = 0;
+	std::vector<Coord> corners, touching;
+	Coord first = { 0, 0 };
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			State state = board.stateAt(x, y);
+			if (state == FLAG)
+				flags++;
+			if (state != UNKNOWN || cellBits[static_cast<size_t>(y) * width + x].first >= 0)
+				continue;
+
+			Coord cell = { static_cast<size_t>(x), static_cast<size_t>(y) };
+			if (outsideCells++ == 0)
+				first = cell;
+			if ((x == 0 || x == width - 1) && (y == 0 || y == height - 1)) {
+				corners.push_back(cell);
+				continue;
+			}
+
+			bool nextToSection = false;
+			for (int dy = -1; dy < 2 && !nextToSection; ++dy) {
+				for (int dx = -1; dx < 2; ++dx) {
+					int nx = x + dx;
+					int ny = y + dy;
+					if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
+						cellBits[static_cast<size_t>(ny) * width + nx].first >= 0) {
+						nextToSection = true;
+						break;
+					}
+				}
+			}
+			if (nextToSection)
+				touching.push_back(cell);
+		}
+	}
+
+	std::vector<Coord> outside = corners;
+	if (outside.empty() && outsideCells > 0)
+		outside.push_back(first);
+	for (const Coord& cell : touching)
+		if (!(cell == outside[0]))
+			outside.push_back(cell);
+	if (outside.size() > static_cast<size_t>(std::max(outsideCandidates, 1)))
+		outside.resize(std::max(outsideCandidates, 1));
+
+	double density = defaultDensity;
+	if (totalMines > 0 && outsideCells > 0)
+		density = (totalMines - flags - frontierMines) / outsideCells;
+	else if (frontierCells > 0)
+		density = frontierMines / frontierCells;
+	density = std::min(std::max(density, 0.0), 1.0);
+
+	for (const Coord& cell : outside)
+		candidates.push_back({ cell, density, 0, false });
+
+	std::stable_sort(candidates.begin(), candidates.end(),
+		[](const GuessCandidate& a, const GuessCandidate& b) { return a.mineChance < b.mineChance; });
+	return density;
+}
+
+void GuessEvaluator::addTrials(const BitBoard& board, const std::vector<SectionCache>& sections, double density, int id) {
+	const Coord& cell = candidates[id].cell;
+	int width = board.width();
+	int height = board.height();
+	auto own = cellBits[cell.y * width + cell.x];
+
+	// The candidate's unknown neighbors, split by the section they belong to.
+	int flags = 0;
+	int outside = 0;
+	std::vector<std::pair<int, uint32_t>> touched;
+	if (own.first >= 0)
+		touched.push_back({ own.first, 0 });
+	for (int dy = -1; dy < 2; ++dy) {
+		for (int dx = -1; dx < 2; ++dx) {
+			int nx = static_cast<int>(cell.x) + dx;
+			int ny = static_cast<int>(cell.y) + dy;
+			if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+				continue;
+
+			State state = board.stateAt(nx, ny);
+			if (state == FLAG)
+				flags++;
+			if (state != UNKNOWN)
+				continue;
+
+			auto bits = cellBits[static_cast<size_t>(ny) * width + nx];
+			if (bits.first < 0) {
+				outside++;
+				continue;
+			}
+			auto it = std::find_if(touched.begin(), touched.end(),
+				[&](const std::pair<int, uint32_t>& entry) { return entry.first == bits.first; });
+			if (it == touched.end())
+				touched.push_back({ bits.first, 1u << bits.second });
+			else
+				it->second |= 1u << bits.second;
+		}
+	}
+
+	// Distribution of the mines around the candidate, given it is safe.
+	std::vector<double> dist(9, 0);
+	dist[0] = 1;
+	for (const auto& [sid, neighbors] : touched) {
+		uint32_t ownBit = sid == own.first ? 1u << own.second : 0;
+		std::vector<double> sectionDist(9, 0);
+		int safeSolutions = 0;
+		for (uint32_t solution : sections[sid].solutions) {
+			if (solution & ownBit)
+				continue;
+			sectionDist[countBits(solution & neighbors)] += 1;
+			safeSolutions++;
+		}
+		if (safeSolutions == 0)
+			return;
+		for (double& chance : sectionDist)
+			chance /= safeSolutions;
+		convolve(dist, sectionDist);
+	}
+
+	// Neighbors outside every section are mines independently at 'density'.
+	std::vector<double> outsideDist(outside + 1, 0);
+	double ways = 1;
+	for (int mines = 0; mines <= outside; ++mines) {
+		outsideDist[mines] = ways * std::pow(density, mines) * std::pow(1 - density, outside - mines);
+		ways = ways * (outside - mines) / (mines + 1);
+	}
+	convolve(dist, outsideDist);
+
+	for (int mines = 0; flags + mines <= 8; ++mines)
+		if (dist[mines] > 0)
+			trials.push_back({ id, flags + mines, dist[mines], -1 });
+}
+
+int GuessEvaluator::runTrial(const BitBoard& board, const Trial& trial) const {
+	const Coord& cell = candidates[trial.candidate].cell;
+	BitBoard revealed = board;
+	revealed.revealNumber(static_cast<int>(cell.x), static_cast<int>(cell.y), trial.value);
+	return countForced(revealed);
+}
+
+bool GuessEvaluator::choose(const BitBoard& board, const std::vector<SectionCache>& sections, int totalMines,
+	std::chrono::steady_clock::time_point deadline, Coord& guess) {
+	timedOut = false;
+	double density = collectCandidates(board, sections, totalMines);
+	if (candidates.empty())
+		return false;
+
+	// Only cells about as safe as the safest are worth trading safety for information.
+	size_t keep = 1;
+	size_t limit = lookahead ? static_cast<size_t>(std::max(maxCandidates, 1)) : 1;
+	while (keep < candidates.size() && keep < limit &&
+		candidates[keep].mineChance <= candidates[0].mineChance + chanceSlack)
+		++keep;
+	candidates.resize(keep);
+
+	guess = candidates[0].cell;
+	if (keep == 1)
+		return true;
+
+	trials.clear();
+	for (int id = 0; id < candidates.size(); ++id)
+		addTrials(board, sections, density, id);
+
+	// Moves the rules already force without any guess don't count for any candidate.
+	BitBoard unchanged = board;
+	int baseline = countForced(unchanged);
+
+	// Trials are claimed in order, so the safest candidates finish first.
+	std::atomic<size_t> nextTrial(0);
+	auto work = [&]() {
+		while (std::chrono::steady_clock::now() < deadline) {
+			size_t id = nextTrial++;
+			if (id >= trials.size())
+				return;
+			trials[id].forced = std::max(runTrial(board, trials[id]) - baseline, 0);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	size_t threadCount = std::min<size_t>(workers, trials.size());
+	for (size_t i = 1; i < threadCount; ++i)
+		threads.emplace_back(work);
+	work();
+	for (auto& thread : threads)
+		thread.join();
+
+	for (auto& candidate : candidates)
+		candidate.evaluated = true;
+	for (const auto& trial : trials) {
+		GuessCandidate& candidate = candidates[trial.candidate];
+		if (trial.forced < 0) {
+			candidate.evaluated = false;
+			timedOut = true;
+		}
+		else
+			candidate.expectedForced += trial.chance * trial.forced;
+	}
+
+	double bestScore = 0;
+	for (const auto& candidate : candidates) {
+		if (!candidate.evaluated)
+			continue;
+		double score = (1 - candidate.mineChance) * candidate.expectedForced;
+		if (score > bestScore) {
+			bestScore = score;
+			guess = candidate.cell;
+		}
+	}
+	return true;
+}
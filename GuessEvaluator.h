@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "BitBoard.h"
+#include "BoardParser.h"
+
+struct SectionCache;
+
+// A cell the guess evaluator considered revealing.
+struct GuessCandidate {
+	Coord cell;					// The cell.
+	double mineChance;			// Chance that the cell is a mine.
+	double expectedForced;		// Moves the single-cell rules are expected to force once it is revealed.
+	bool evaluated;				// Whether every number it could show was tried before the deadline.
+};
+
+// Chooses a cell to reveal when no move is certain. The candidates are the cells
+// least likely to be mines. For each one, every number it could show is tried on
+// a copy of the board, weighted by how likely it is, and the single-cell rules are
+// run on the result until they force nothing new. A candidate scores its chance of
+// being safe times the number of moves it is expected to force, so among cells
+// that are about as safe, the one that unlocks the most wins.
+//
+// The chance of each number comes from the valid assignments of the CSP sections
+// around the cell, treating sections as independent. Unknown cells outside every
+// section are assumed to be mines at the density of the mines left over.
+//
+// Candidates and numbers are tried in parallel, safest candidate first, and no
+// new trial starts after the deadline. A candidate with an untried number keeps
+// only its mine chance.
+class GuessEvaluator {
+public:
+	// Constructor. Uses one worker per hardware thread.
+	GuessEvaluator();
+
+	// Picks the cell to reveal on 'board', given the sections solved on it and the
+	// number of mines on the whole board (0 if unknown). Returns false if no
+	// unknown cell is left.
+	bool choose(const BitBoard& board, const std::vector<SectionCache>& sections, int totalMines,
+		std::chrono::steady_clock::time_point deadline, Coord& guess);
+
+	// Returns every candidate considered by the last call to choose(), safest first.
+	const std::vector<GuessCandidate>& returnCandidates() const;
+
+	bool lookahead;			// Whether to try numbers at all; false simply picks the safest cell.
+	unsigned workers;		// Threads the trials are split across.
+	int maxCandidates;		// Most candidates tried per guess.
+	double chanceSlack;		// Candidates can be at most this much likelier to be mines than the safest cell.
+	int outsideCandidates;	// Most candidates outside every section, which are all equally likely to be mines.
+	bool timedOut;			// Whether the last choose() reached its deadline before every trial ran.
+
+private:
+	// One number a candidate could show, and how likely it is given the candidate is safe.
+	struct Trial {
+		int candidate;		// Index in 'candidates'.
+		int value;			// Number shown.
+		double chance;		// Chance of showing it.
+		int forced;			// Moves forced after showing it; -1 until tried.
+	};
+
+	std::vector<GuessCandidate> candidates;		// Candidates of the last guess, safest first.
+	std::vector<Trial> trials;					// Every number of every candidate, by candidate.
+	std::vector<std::pair<int, int>> cellBits;	// Section index and bit of every cell, row-major; -1 if in no section.
+
+	// Fills 'candidates' with every unknown cell in a section and one cell
+	// outside every section, with their mine chances. Returns the mine density
+	// assumed outside every section.
+	double collectCandidates(const BitBoard& board, const std::vector<SectionCache>& sections, int totalMines);
+
+	// Appends a trial for every number candidate 'id' could show.
+	void addTrials(const BitBoard& board, const std::vector<SectionCache>& sections, double density, int id);
+
+	// Reveals the trial's number on a copy of 'board' and counts the moves the
+	// single-cell rules force, round after round.
+	int runTrial(const BitBoard& board, const Trial& trial) const;
+};
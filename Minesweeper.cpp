@@ -1,8 +1,18 @@
+#include <chrono>
 #include <iostream>
+#include <string>
 #include <windows.h>
 #include "BoardParser.h"
 #include "CaptureBoard.h"
+#include "SessionLog.h"
 #include "Solver.h"
+#include "TurnScheduler.h"
+
+// Returns the microseconds elapsed since 'start'.
+static uint32_t microsSince(std::chrono::steady_clock::time_point start) {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
 
 // Moves the cursor to the top left of the main monitor
 // and waits for particle effects to dissipate or for
@@ -21,70 +31,114 @@ static void initializeGame(CaptureBoard& capture) {
 	capture.startGame();
 }
 
-// Performs a single game turn:
-// 1. Captures the current board image.
-// 2. Parses the image into useable cell states.
-// 3. Finds guaranteed mines and safe cells using deterministic logic.
-// 4. Clicks the board according to the data found in step 3.
-static void processTurn(CaptureBoard& capture, BoardParser& parser, Solver& solver) {
+// Appends the turn that just finished to the session log, if one is open.
+// Frames are only recorded for turns that captured the screen.
+static void recordTurn(SessionRecorder& recorder, uint32_t& turn, bool captured, const CaptureBoard& capture,
+	const BoardParser& parser, const Solver& solver,
+	uint32_t captureMicros, uint32_t parseMicros, uint32_t solveMicros) {
+	if (!recorder.isOpen())
+		return;
+
+	TurnRecord record = SessionRecorder::makeRecord(turn++, solver, parser.returnBoard());
+	record.captureMicros = captureMicros;
+	record.parseMicros = parseMicros;
+	record.solveMicros = solveMicros;
+	recorder.recordTurn(record, captured ? capture.returnImg() : BoardImage());
+}
+
+// Brings the parsed board up to date with the last turn's clicks. Captures and
+// parses the screen, unless the last turn only placed flags, in which case they
+// are applied to the parsed board directly. Returns false if the game is over.
+static bool readBoard(CaptureBoard& capture, BoardParser& parser, const Solver& solver,
+	bool& captured, uint32_t& captureMicros, uint32_t& parseMicros) {
+	captured = solver.needsCapture();
+	captureMicros = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	if (!captured) {
+		std::vector<Coord> flags;
+		for (const auto& action : solver.returnActions())
+			flags.push_back({ action.x, action.y });
+		parser.applyFlags(flags);
+		parseMicros = microsSince(start);
+		return true;
+	}
+
 	capture.captureScreen();
+	captureMicros = microsSince(start);
 
+	start = std::chrono::steady_clock::now();
 	parser.update(capture.returnImg());
 	parser.parseCells();
 	
-	if (parser.gameOver) {
-		solver.progress = false;
-		return;
-	}
+	if (parser.gameOver)
+		return false;
 
 	parser.initParsedBoard();
-
-	solver.update(parser.returnBoard());
-	solver.solveStep();
-
-	capture.applyActions(solver.returnActions());
+	parseMicros = microsSince(start);
+	return true;
 }
 
 // Performs a single game turn:
-// 1. Captures the current board image.
+// 1. Captures the current board image, if the last turn revealed anything.
 // 2. Parses the image into useable cell states.
-// 3. Finds guaranteed mines and safe cells using constraint satisfaction.
+// 3. Finds guaranteed mines and safe cells, escalating from deterministic logic
+//    to the pattern table to constraint satisfaction, and guesses if none are
+//    certain, all within the scheduler's budget.
 // 4. Clicks the board according to the data found in step 3.
-static void processCSPTurn(CaptureBoard& capture, BoardParser& parser, Solver& solver) {
-	capture.captureScreen();
-
-	parser.update(capture.returnImg());
-	parser.parseCells();
-
-	if (parser.gameOver) {
+static void processTurn(CaptureBoard& capture, BoardParser& parser, Solver& solver,
+	const TurnScheduler& scheduler, SessionRecorder& recorder, uint32_t& turn) {
+	bool captured;
+	uint32_t captureMicros, parseMicros;
+	if (!readBoard(capture, parser, solver, captured, captureMicros, parseMicros)) {
+		// Nothing cached about this board holds for the next game.
+		solver.newGame();
 		solver.progress = false;
 		return;
 	}
 
-	parser.initParsedBoard();
-
-	solver.update(parser.returnBoard());
-	solver.CSPTurn();
+	auto start = std::chrono::steady_clock::now();
+	const auto& board = parser.returnBoard();
+	solver.update(board, parser.returnTiles());
+	solver.totalMines = board.empty() ? 0 : googleMineCount(board[0].size(), board.size());
+	scheduler.run(solver);
+	uint32_t solveMicros = microsSince(start);
 
+	recordTurn(recorder, turn, captured, capture, parser, solver, captureMicros, parseMicros, solveMicros);
 	capture.applyActions(solver.returnActions());
 }
 
-int main()
+// Waits for the clicks just made to show up on screen, unless the
+// next turn won't capture the screen anyway.
+static void waitForTurn(const Solver& solver) {
+	if (solver.needsCapture())
+		wait(100);
+}
+
+// Usage: minesweeper [session log] [--frames]
+// With a session log path, every turn is appended to that log for later replay.
+// --frames also records the pixels of every cell that changed.
+int main(int argc, char* argv[])
 {
 	CaptureBoard capture;
 	BoardParser parser;
 	Solver solver;
+	TurnScheduler scheduler;
+	SessionRecorder recorder;
+	uint32_t turn = 0;
+
+	if (argc > 1) {
+		bool frames = argc > 2 && std::string(argv[2]) == "--frames";
+		if (!recorder.open(argv[1], frames))
+			std::cout << "could not open session log " << argv[1] << '\n';
+	}
 
 	initializeGame(capture);
 	wait(750);
 
 	while (solver.progress) {
-		while (solver.progress) {
-			processTurn(capture, parser, solver);
-			wait(100);
-		}
-		processCSPTurn(capture, parser, solver);
-		wait(100);
+		processTurn(capture, parser, solver, scheduler, recorder, turn);
+		waitForTurn(solver);
 	}
 
 	return 0;
@@ -0,0 +1,114 @@
+// Offline generator for PatternTable.cpp. Not part of the solver build;
+// compile and run it on its own whenever the pattern encoding changes:
+//
+//     g++ -std=c++17 -O2 PatternGen.cpp -o patterngen && ./patterngen > PatternTable.cpp
+//
+// Every pattern (see PatternTable.h) is solved exhaustively: each assignment of
+// mines to its cells is checked against both numbers, and a region is forced if
+// it holds no mines, or only mines, in every valid assignment.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "PatternTable.h"
+
+// Returns the number of set bits in 'mask'.
+static int countBits(uint32_t mask) {
+	int count = 0;
+	for (; mask; mask &= mask - 1)
+		++count;
+	return count;
+}
+
+// Returns a mask with bits [start, start + length) set.
+static uint32_t regionMask(int start, int length) {
+	return ((1u << length) - 1) << start;
+}
+
+// Solves every pattern with the given region sizes and appends the ones
+// that force something to 'entries'.
+static void solveRegions(int firstOnly, int shared, int secondOnly, std::vector<PatternEntry>& entries) {
+	// Cells are laid out first-only, then shared, then second-only.
+	const uint32_t regions[3] = {
+		regionMask(0, firstOnly),
+		regionMask(firstOnly, shared),
+		regionMask(firstOnly + shared, secondOnly),
+	};
+	const uint32_t firstSees = regions[FIRST_ONLY] | regions[SHARED];
+	const uint32_t secondSees = regions[SHARED] | regions[SECOND_ONLY];
+	const int cells = firstOnly + shared + secondOnly;
+
+	// For every pair of mine counts: the cells that are a mine in some valid
+	// assignment, the cells that are a mine in all of them, and whether any exist.
+	uint32_t anyMine[9][9] = {};
+	uint32_t allMine[9][9];
+	bool valid[9][9] = {};
+	for (auto& row : allMine)
+		for (auto& mask : row)
+			mask = ~0u;
+
+	for (uint32_t mines = 0; mines < (1u << cells); ++mines) {
+		int firstMines = countBits(mines & firstSees);
+		int secondMines = countBits(mines & secondSees);
+		anyMine[firstMines][secondMines] |= mines;
+		allMine[firstMines][secondMines] &= mines;
+		valid[firstMines][secondMines] = true;
+	}
+
+	for (int firstMines = 0; firstMines <= 8; ++firstMines) {
+		for (int secondMines = 0; secondMines <= 8; ++secondMines) {
+			if (!valid[firstMines][secondMines])
+				continue;
+
+			// Either number could solve this alone, so the single-cell rules already do.
+			if (firstMines == 0 || firstMines == countBits(firstSees) ||
+				secondMines == 0 || secondMines == countBits(secondSees))
+				continue;
+
+			uint8_t result = 0;
+			for (int region = FIRST_ONLY; region <= SECOND_ONLY; ++region) {
+				uint32_t cellsInRegion = regions[region];
+				if (!cellsInRegion)
+					continue;
+				if (!(anyMine[firstMines][secondMines] & cellsInRegion))
+					result |= FORCED_SAFE << (2 * region);
+				else if ((allMine[firstMines][secondMines] & cellsInRegion) == cellsInRegion)
+					result |= FORCED_MINE << (2 * region);
+			}
+
+			if (result)
+				entries.push_back({ patternKey(firstOnly, shared, secondOnly, firstMines, secondMines), result });
+		}
+	}
+}
+
+int main() {
+	std::vector<PatternEntry> entries;
+
+	// A number has at most 8 unknown neighbors, and a pattern needs a shared cell.
+	for (int firstOnly = 0; firstOnly <= 7; ++firstOnly)
+		for (int shared = 1; firstOnly + shared <= 8; ++shared)
+			for (int secondOnly = 0; shared + secondOnly <= 8; ++secondOnly)
+				solveRegions(firstOnly, shared, secondOnly, entries);
+
+	// Keys grow with the loop order above, so 'entries' is already sorted.
+	std::printf("// Generated by PatternGen.cpp. Do not edit by hand.\n\n");
+	std::printf("#include <algorithm>\n");
+	std::printf("#include \"PatternTable.h\"\n\n");
+	std::printf("const PatternEntry patternTable[] = {\n");
+	for (size_t i = 0; i < entries.size(); ++i) {
+		std::printf("%s{ %5u, 0x%02x },", i % 6 == 0 ? "\t" : " ", entries[i].key, entries[i].result);
+		if (i % 6 == 5 || i + 1 == entries.size())
+			std::printf("\n");
+	}
+	std::printf("};\n\n");
+	std::printf("const size_t patternTableSize = sizeof(patternTable) / sizeof(patternTable[0]);\n\n");
+	std::printf("uint8_t lookupPattern(uint16_t key) {\n");
+	std::printf("\tconst PatternEntry* end = patternTable + patternTableSize;\n");
+	std::printf("\tconst PatternEntry* it = std::lower_bound(patternTable, end, key,\n");
+	std::printf("\t\t[](const PatternEntry& entry, uint16_t k) { return entry.key < k; });\n");
+	std::printf("\treturn (it != end && it->key == key) ? it->result : 0;\n");
+	std::printf("}\n");
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+// Generated by PatternGen.cpp. Do not edit by hand.
+
+#include <algorithm>
+#include "PatternTable.h"
+
+const PatternEntry patternTable[] = {
+	{  1549, 0x10 }, {  1550, 0x20 }, {  1630, 0x10 }, {  1632, 0x20 }, {  1711, 0x10 }, {  1714, 0x20 },
+	{  1792, 0x10 }, {  1796, 0x20 }, {  1873, 0x10 }, {  1878, 0x20 }, {  1954, 0x10 }, {  1960, 0x20 },
+	{  2278, 0x10 }, {  2279, 0x20 }, {  2288, 0x10 }, {  2289, 0x20 }, {  2359, 0x10 }, {  2361, 0x20 },
+	{  2369, 0x10 }, {  2371, 0x20 }, {  2440, 0x10 }, {  2443, 0x20 }, {  2450, 0x10 }, {  2453, 0x20 },
+	{  2521, 0x10 }, {  2525, 0x20 }, {  2531, 0x10 }, {  2535, 0x20 }, {  2602, 0x10 }, {  2607, 0x20 },
+	{  2612, 0x10 }, {  2617, 0x20 }, {  3007, 0x10 }, {  3008, 0x20 }, {  3017, 0x10 }, {  3018, 0x20 },
+	{  3027, 0x10 }, {  3028, 0x20 }, {  3088, 0x10 }, {  3090, 0x20 }, {  3098, 0x10 }, {  3100, 0x20 },
+	{  3108, 0x10 }, {  3110, 0x20 }, {  3169, 0x10 }, {  3172, 0x20 }, {  3179, 0x10 }, {  3182, 0x20 },
+	{  3189, 0x10 }, {  3192, 0x20 }, {  3250, 0x10 }, {  3254, 0x20 }, {  3260, 0x10 }, {  3264, 0x20 },
+	{  3270, 0x10 }, {  3274, 0x20 }, {  3736, 0x10 }, {  3737, 0x20 }, {  3746, 0x10 }, {  3747, 0x20 },
+	{  3756, 0x10 }, {  3757, 0x20 }, {  3766, 0x10 }, {  3767, 0x20 }, {  3817, 0x10 }, {  3819, 0x20 },
+	{  3827, 0x10 }, {  3829, 0x20 }, {  3837, 0x10 }, {  3839, 0x20 }, {  3847, 0x10 }, {  3849, 0x20 },
+	{  3898, 0x10 }, {  3901, 0x20 }, {  3908, 0x10 }, {  3911, 0x20 }, {  3918, 0x10 }, {  3921, 0x20 },
+	{  3928, 0x10 }, {  3931, 0x20 }, {  4465, 0x10 }, {  4466, 0x20 }, {  4475, 0x10 }, {  4476, 0x20 },
+	{  4485, 0x10 }, {  4486, 0x20 }, {  4495, 0x10 }, {  4496, 0x20 }, {  4505, 0x10 }, {  4506, 0x20 },
+	{  4546, 0x10 }, {  4548, 0x20 }, {  4556, 0x10 }, {  4558, 0x20 }, {  4566, 0x10 }, {  4568, 0x20 },
+	{  4576, 0x10 }, {  4578, 0x20 }, {  4586, 0x10 }, {  4588, 0x20 }, {  5194, 0x10 }, {  5195, 0x20 },
+	{  5204, 0x10 }, {  5205, 0x20 }, {  5214, 0x10 }, {  5215, 0x20 }, {  5224, 0x10 }, {  5225, 0x20 },
+	{  5234, 0x10 }, {  5235, 0x20 }, {  5244, 0x10 }, {  5245, 0x20 }, {  8029, 0x01 }, {  8038, 0x02 },
+	{  8111, 0x21 }, {  8119, 0x12 }, {  8193, 0x21 }, {  8200, 0x12 }, {  8275, 0x21 }, {  8281, 0x12 },
+	{  8357, 0x21 }, {  8362, 0x12 }, {  8439, 0x21 }, {  8443, 0x12 }, {  8521, 0x21 }, {  8524, 0x12 },
+	{  8758, 0x01 }, {  8767, 0x02 }, {  8768, 0x01 }, {  8777, 0x02 }, {  8840, 0x21 }, {  8848, 0x12 },
+	{  8850, 0x21 }, {  8858, 0x12 }, {  8922, 0x21 }, {  8929, 0x12 }, {  8932, 0x21 }, {  8939, 0x12 },
+	{  9004, 0x21 }, {  9010, 0x12 }, {  9014, 0x21 }, {  9020, 0x12 }, {  9086, 0x21 }, {  9091, 0x12 },
+	{  9096, 0x21 }, {  9101, 0x12 }, {  9168, 0x21 }, {  9172, 0x12 }, {  9178, 0x21 }, {  9182, 0x12 },
+	{  9487, 0x01 }, {  9496, 0x02 }, {  9497, 0x01 }, {  9506, 0x02 }, {  9507, 0x01 }, {  9516, 0x02 },
+	{  9569, 0x21 }, {  9577, 0x12 }, {  9579, 0x21 }, {  9587, 0x12 }, {  9589, 0x21 }, {  9597, 0x12 },
+	{  9651, 0x21 }, {  9658, 0x12 }, {  9661, 0x21 }, {  9668, 0x12 }, {  9671, 0x21 }, {  9678, 0x12 },
+	{  9733, 0x21 }, {  9739, 0x12 }, {  9743, 0x21 }, {  9749, 0x12 }, {  9753, 0x21 }, {  9759, 0x12 },
+	{  9815, 0x21 }, {  9820, 0x12 }, {  9825, 0x21 }, {  9830, 0x12 }, {  9835, 0x21 }, {  9840, 0x12 },
+	{ 10216, 0x01 }, { 10225, 0x02 }, { 10226, 0x01 }, { 10235, 0x02 }, { 10236, 0x01 }, { 10245, 0x02 },
+	{ 10246, 0x01 }, { 10255, 0x02 }, { 10298, 0x21 }, { 10306, 0x12 }, { 10308, 0x21 }, { 10316, 0x12 },
+	{ 10318, 0x21 }, { 10326, 0x12 }, { 10328, 0x21 }, { 10336, 0x12 }, { 10380, 0x21 }, { 10387, 0x12 },
+	{ 10390, 0x21 }, { 10397, 0x12 }, { 10400, 0x21 }, { 10407, 0x12 }, { 10410, 0x21 }, { 10417, 0x12 },
+	{ 10462, 0x21 }, { 10468, 0x12 }, { 10472, 0x21 }, { 10478, 0x12 }, { 10482, 0x21 }, { 10488, 0x12 },
+	{ 10492, 0x21 }, { 10498, 0x12 }, { 10945, 0x01 }, { 10954, 0x02 }, { 10955, 0x01 }, { 10964, 0x02 },
+	{ 10965, 0x01 }, { 10974, 0x02 }, { 10975, 0x01 }, { 10984, 0x02 }, { 10985, 0x01 }, { 10994, 0x02 },
+	{ 11027, 0x21 }, { 11035, 0x12 }, { 11037, 0x21 }, { 11045, 0x12 }, { 11047, 0x21 }, { 11055, 0x12 },
+	{ 11057, 0x21 }, { 11065, 0x12 }, { 11067, 0x21 }, { 11075, 0x12 }, { 11109, 0x21 }, { 11116, 0x12 },
+	{ 11119, 0x21 }, { 11126, 0x12 }, { 11129, 0x21 }, { 11136, 0x12 }, { 11139, 0x21 }, { 11146, 0x12 },
+	{ 11149, 0x21 }, { 11156, 0x12 }, { 11674, 0x01 }, { 11683, 0x02 }, { 11684, 0x01 }, { 11693, 0x02 },
+	{ 11694, 0x01 }, { 11703, 0x02 }, { 11704, 0x01 }, { 11713, 0x02 }, { 11714, 0x01 }, { 11723, 0x02 },
+	{ 11724, 0x01 }, { 11733, 0x02 }, { 11756, 0x21 }, { 11764, 0x12 }, { 11766, 0x21 }, { 11774, 0x12 },
+	{ 11776, 0x21 }, { 11784, 0x12 }, { 11786, 0x21 }, { 11794, 0x12 }, { 11796, 0x21 }, { 11804, 0x12 },
+	{ 11806, 0x21 }, { 11814, 0x12 }, { 14590, 0x01 }, { 14608, 0x02 }, { 14672, 0x21 }, { 14689, 0x12 },
+	{ 14754, 0x21 }, { 14770, 0x12 }, { 14836, 0x21 }, { 14851, 0x12 }, { 14918, 0x21 }, { 14932, 0x12 },
+	{ 15000, 0x21 }, { 15013, 0x12 }, { 15082, 0x21 }, { 15094, 0x12 }, { 15319, 0x01 }, { 15329, 0x01 },
+	{ 15337, 0x02 }, { 15347, 0x02 }, { 15401, 0x21 }, { 15411, 0x21 }, { 15418, 0x12 }, { 15428, 0x12 },
+	{ 15483, 0x21 }, { 15493, 0x21 }, { 15499, 0x12 }, { 15509, 0x12 }, { 15565, 0x21 }, { 15575, 0x21 },
+	{ 15580, 0x12 }, { 15590, 0x12 }, { 15647, 0x21 }, { 15657, 0x21 }, { 15661, 0x12 }, { 15671, 0x12 },
+	{ 15729, 0x21 }, { 15739, 0x21 }, { 15742, 0x12 }, { 15752, 0x12 }, { 16048, 0x01 }, { 16058, 0x01 },
+	{ 16066, 0x02 }, { 16068, 0x01 }, { 16076, 0x02 }, { 16086, 0x02 }, { 16130, 0x21 }, { 16140, 0x21 },
+	{ 16147, 0x12 }, { 16150, 0x21 }, { 16157, 0x12 }, { 16167, 0x12 }, { 16212, 0x21 }, { 16222, 0x21 },
+	{ 16228, 0x12 }, { 16232, 0x21 }, { 16238, 0x12 }, { 16248, 0x12 }, { 16294, 0x21 }, { 16304, 0x21 },
+	{ 16309, 0x12 }, { 16314, 0x21 }, { 16319, 0x12 }, { 16329, 0x12 }, { 16376, 0x21 }, { 16386, 0x21 },
+	{ 16390, 0x12 }, { 16396, 0x21 }, { 16400, 0x12 }, { 16410, 0x12 }, { 16777, 0x01 }, { 16787, 0x01 },
+	{ 16795, 0x02 }, { 16797, 0x01 }, { 16805, 0x02 }, { 16807, 0x01 }, { 16815, 0x02 }, { 16825, 0x02 },
+	{ 16859, 0x21 }, { 16869, 0x21 }, { 16876, 0x12 }, { 16879, 0x21 }, { 16886, 0x12 }, { 16889, 0x21 },
+	{ 16896, 0x12 }, { 16906, 0x12 }, { 16941, 0x21 }, { 16951, 0x21 }, { 16957, 0x12 }, { 16961, 0x21 },
+	{ 16967, 0x12 }, { 16971, 0x21 }, { 16977, 0x12 }, { 16987, 0x12 }, { 17023, 0x21 }, { 17033, 0x21 },
+	{ 17038, 0x12 }, { 17043, 0x21 }, { 17048, 0x12 }, { 17053, 0x21 }, { 17058, 0x12 }, { 17068, 0x12 },
+	{ 17506, 0x01 }, { 17516, 0x01 }, { 17524, 0x02 }, { 17526, 0x01 }, { 17534, 0x02 }, { 17536, 0x01 },
+	{ 17544, 0x02 }, { 17546, 0x01 }, { 17554, 0x02 }, { 17564, 0x02 }, { 17588, 0x21 }, { 17598, 0x21 },
+	{ 17605, 0x12 }, { 17608, 0x21 }, { 17615, 0x12 }, { 17618, 0x21 }, { 17625, 0x12 }, { 17628, 0x21 },
+	{ 17635, 0x12 }, { 17645, 0x12 }, { 17670, 0x21 }, { 17680, 0x21 }, { 17686, 0x12 }, { 17690, 0x21 },
+	{ 17696, 0x12 }, { 17700, 0x21 }, { 17706, 0x12 }, { 17710, 0x21 }, { 17716, 0x12 }, { 17726, 0x12 },
+	{ 21151, 0x01 }, { 21178, 0x02 }, { 21233, 0x21 }, { 21259, 0x12 }, { 21315, 0x21 }, { 21340, 0x12 },
+	{ 21397, 0x21 }, { 21421, 0x12 }, { 21479, 0x21 }, { 21502, 0x12 }, { 21561, 0x21 }, { 21583, 0x12 },
+	{ 21643, 0x21 }, { 21664, 0x12 }, { 21880, 0x01 }, { 21890, 0x01 }, { 21907, 0x02 }, { 21917, 0x02 },
+	{ 21962, 0x21 }, { 21972, 0x21 }, { 21988, 0x12 }, { 21998, 0x12 }, { 22044, 0x21 }, { 22054, 0x21 },
+	{ 22069, 0x12 }, { 22079, 0x12 }, { 22126, 0x21 }, { 22136, 0x21 }, { 22150, 0x12 }, { 22160, 0x12 },
+	{ 22208, 0x21 }, { 22218, 0x21 }, { 22231, 0x12 }, { 22241, 0x12 }, { 22290, 0x21 }, { 22300, 0x21 },
+	{ 22312, 0x12 }, { 22322, 0x12 }, { 22609, 0x01 }, { 22619, 0x01 }, { 22629, 0x01 }, { 22636, 0x02 },
+	{ 22646, 0x02 }, { 22656, 0x02 }, { 22691, 0x21 }, { 22701, 0x21 }, { 22711, 0x21 }, { 22717, 0x12 },
+	{ 22727, 0x12 }, { 22737, 0x12 }, { 22773, 0x21 }, { 22783, 0x21 }, { 22793, 0x21 }, { 22798, 0x12 },
+	{ 22808, 0x12 }, { 22818, 0x12 }, { 22855, 0x21 }, { 22865, 0x21 }, { 22875, 0x21 }, { 22879, 0x12 },
+	{ 22889, 0x12 }, { 22899, 0x12 }, { 22937, 0x21 }, { 22947, 0x21 }, { 22957, 0x21 }, { 22960, 0x12 },
+	{ 22970, 0x12 }, { 22980, 0x12 }, { 23338, 0x01 }, { 23348, 0x01 }, { 23358, 0x01 }, { 23365, 0x02 },
+	{ 23368, 0x01 }, { 23375, 0x02 }, { 23385, 0x02 }, { 23395, 0x02 }, { 23420, 0x21 }, { 23430, 0x21 },
+	{ 23440, 0x21 }, { 23446, 0x12 }, { 23450, 0x21 }, { 23456, 0x12 }, { 23466, 0x12 }, { 23476, 0x12 },
+	{ 23502, 0x21 }, { 23512, 0x21 }, { 23522, 0x21 }, { 23527, 0x12 }, { 23532, 0x21 }, { 23537, 0x12 },
+	{ 23547, 0x12 }, { 23557, 0x12 }, { 23584, 0x21 }, { 23594, 0x21 }, { 23604, 0x21 }, { 23608, 0x12 },
+	{ 23614, 0x21 }, { 23618, 0x12 }, { 23628, 0x12 }, { 23638, 0x12 }, { 27712, 0x01 }, { 27748, 0x02 },
+	{ 27794, 0x21 }, { 27829, 0x12 }, { 27876, 0x21 }, { 27910, 0x12 }, { 27958, 0x21 }, { 27991, 0x12 },
+	{ 28040, 0x21 }, { 28072, 0x12 }, { 28122, 0x21 }, { 28153, 0x12 }, { 28204, 0x21 }, { 28234, 0x12 },
+	{ 28441, 0x01 }, { 28451, 0x01 }, { 28477, 0x02 }, { 28487, 0x02 }, { 28523, 0x21 }, { 28533, 0x21 },
+	{ 28558, 0x12 }, { 28568, 0x12 }, { 28605, 0x21 }, { 28615, 0x21 }, { 28639, 0x12 }, { 28649, 0x12 },
+	{ 28687, 0x21 }, { 28697, 0x21 }, { 28720, 0x12 }, { 28730, 0x12 }, { 28769, 0x21 }, { 28779, 0x21 },
+	{ 28801, 0x12 }, { 28811, 0x12 }, { 28851, 0x21 }, { 28861, 0x21 }, { 28882, 0x12 }, { 28892, 0x12 },
+	{ 29170, 0x01 }, { 29180, 0x01 }, { 29190, 0x01 }, { 29206, 0x02 }, { 29216, 0x02 }, { 29226, 0x02 },
+	{ 29252, 0x21 }, { 29262, 0x21 }, { 29272, 0x21 }, { 29287, 0x12 }, { 29297, 0x12 }, { 29307, 0x12 },
+	{ 29334, 0x21 }, { 29344, 0x21 }, { 29354, 0x21 }, { 29368, 0x12 }, { 29378, 0x12 }, { 29388, 0x12 },
+	{ 29416, 0x21 }, { 29426, 0x21 }, { 29436, 0x21 }, { 29449, 0x12 }, { 29459, 0x12 }, { 29469, 0x12 },
+	{ 29498, 0x21 }, { 29508, 0x21 }, { 29518, 0x21 }, { 29530, 0x12 }, { 29540, 0x12 }, { 29550, 0x12 },
+	{ 34273, 0x01 }, { 34318, 0x02 }, { 34355, 0x21 }, { 34399, 0x12 }, { 34437, 0x21 }, { 34480, 0x12 },
+	{ 34519, 0x21 }, { 34561, 0x12 }, { 34601, 0x21 }, { 34642, 0x12 }, { 34683, 0x21 }, { 34723, 0x12 },
+	{ 34765, 0x21 }, { 34804, 0x12 }, { 35002, 0x01 }, { 35012, 0x01 }, { 35047, 0x02 }, { 35057, 0x02 },
+	{ 35084, 0x21 }, { 35094, 0x21 }, { 35128, 0x12 }, { 35138, 0x12 }, { 35166, 0x21 }, { 35176, 0x21 },
+	{ 35209, 0x12 }, { 35219, 0x12 }, { 35248, 0x21 }, { 35258, 0x21 }, { 35290, 0x12 }, { 35300, 0x12 },
+	{ 35330, 0x21 }, { 35340, 0x21 }, { 35371, 0x12 }, { 35381, 0x12 }, { 35412, 0x21 }, { 35422, 0x21 },
+	{ 35452, 0x12 }, { 35462, 0x12 }, { 40834, 0x01 }, { 40888, 0x02 }, { 40916, 0x21 }, { 40969, 0x12 },
+	{ 40998, 0x21 }, { 41050, 0x12 }, { 41080, 0x21 }, { 41131, 0x12 }, { 41162, 0x21 }, { 41212, 0x12 },
+	{ 41244, 0x21 }, { 41293, 0x12 }, { 41326, 0x21 }, { 41374, 0x12 },
+};
+
+const size_t patternTableSize = sizeof(patternTable) / sizeof(patternTable[0]);
+
+uint8_t lookupPattern(uint16_t key) {
+	const PatternEntry* end = patternTable + patternTableSize;
+	const PatternEntry* it = std::lower_bound(patternTable, end, key,
+		[](const PatternEntry& entry, uint16_t k) { return entry.key < k; });
+	return (it != end && it->key == key) ? it->result : 0;
+}
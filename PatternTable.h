@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A pattern is a pair of number cells that share at least one unknown neighbor.
+// Their unknown neighbors split into three regions: cells only the first number
+// sees, cells both numbers see, and cells only the second number sees. Since
+// cells within a region are interchangeable, the pattern is fully described by
+// the size of each region and the number of mines each number is still missing.
+
+// The three regions of a pattern.
+enum PatternRegion { FIRST_ONLY, SHARED, SECOND_ONLY };
+
+// What a pattern forces on every cell of a region.
+enum PatternResult { NOT_FORCED, FORCED_SAFE, FORCED_MINE };
+
+// A single precomputed pattern. 'key' comes from patternKey(), 'result' packs
+// one PatternResult per region, two bits each, in PatternRegion order.
+struct PatternEntry {
+	uint16_t key;
+	uint8_t result;
+};
+
+// Generated by PatternGen.cpp; sorted by key. Only holds patterns that force at
+// least one region and that neither number could solve on its own.
+extern const PatternEntry patternTable[];
+extern const size_t patternTableSize;
+
+// Encodes a pattern into its table key. Every argument must be between 0 and 8.
+inline uint16_t patternKey(int firstOnly, int shared, int secondOnly, int firstMines, int secondMines) {
+	return static_cast<uint16_t>((((firstOnly * 9 + shared) * 9 + secondOnly) * 9 + firstMines) * 9 + secondMines);
+}
+
+// Returns the packed result for a key, or 0 if the pattern forces nothing.
+uint8_t lookupPattern(uint16_t key);
+
+// Unpacks the result for one region from a packed result.
+inline PatternResult regionResult(uint8_t result, PatternRegion region) {
+	return static_cast<PatternResult>((result >> (2 * region)) & 3);
+}
@@ -0,0 +1,198 @@
+// Offline replay of a session log recorded by the solver (see SessionLog.h).
+// Not part of the Visual Studio project; it only needs the parser and solver,
+// so it also builds on Linux:
+//
+//     g++ -std=c++17 -O2 -o replay Replay.cpp SessionLog.cpp BoardParser.cpp
+//         BoardImage.cpp Solver.cpp BitBoard.cpp PatternTable.cpp GuessEvaluator.cpp -pthread
+//
+// Usage: replay <session log> [repeat count]
+//
+// Every turn is fed back through BoardParser and Solver exactly as it ran live,
+// with no capture and no waiting, and the emitted actions are checked against the
+// recorded ones. Turns recorded with frames are parsed from their pixels. Repeating
+// the log turns it into a benchmark of the parser and solver.
+//
+// Turns are replayed without a deadline, so a turn that stopped at its deadline
+// live may find more moves or guess differently; those are counted separately.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <tuple>
+#include "BoardParser.h"
+#include "SessionLog.h"
+#include "Solver.h"
+
+// Totals for every turn replayed with one solver tier.
+struct TierStats {
+	int turns = 0;
+	double recordedMicros = 0;
+	double replayedMicros = 0;
+};
+
+// Returns the microseconds elapsed since 'start'.
+static double microsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs the solver the way the live turn did, given the last tier it ran.
+static void runTier(Solver& solver, SolverTier tier) {
+	switch (tier) {
+	case RULES_TIER:
+		solver.solveStep();
+		break;
+	case PATTERN_TIER:
+		solver.solveStep();
+		solver.patternStep();
+		break;
+	case CSP_TIER:
+		solver.CSPTurn();
+		break;
+	case GUESS_TIER:
+		solver.CSPTurn();
+		solver.guessStep(std::chrono::steady_clock::time_point::max());
+		break;
+	default:
+		break;
+	}
+}
+
+// Returns the actions as a sorted list, so two lists can be compared regardless of order.
+static std::vector<std::tuple<int, size_t, size_t>> sortedActions(const std::vector<GridAction>& actions) {
+	std::vector<std::tuple<int, size_t, size_t>> sorted;
+	for (const auto& action : actions)
+		sorted.emplace_back(action.type, action.x, action.y);
+	std::sort(sorted.begin(), sorted.end());
+	return sorted;
+}
+
+// Returns true if 'record' starts a new game after the turn with 'lastStates',
+// or is the first turn of the log. Logs are appended to, so one log can hold
+// several games, each counting its turns from 0. A different board size, or a
+// revealed cell turning unknown again, also means the board was reset.
+static bool startsNewGame(const TurnRecord& record, uint32_t lastTurn, const std::vector<uint8_t>& lastStates) {
+	if (lastStates.empty() || record.turn <= lastTurn || record.states.size() != lastStates.size())
+		return true;
+	for (size_t id = 0; id < lastStates.size(); ++id)
+		if (lastStates[id] != UNKNOWN && record.states[id] == UNKNOWN)
+			return true;
+	return false;
+}
+
+// Returns true if the parsed board matches the recorded cell states.
+static bool matchesStates(const std::vector<std::vector<Cell>>& board, const std::vector<uint8_t>& states) {
+	size_t id = 0;
+	for (const auto& row : board)
+		for (const auto& cell : row)
+			if (id >= states.size() || states[id++] != cell.state)
+				return false;
+	return id == states.size();
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cout << "usage: replay <session log> [repeat count]\n";
+		return 1;
+	}
+	int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1;
+
+	SessionReader reader;
+	if (!reader.open(argv[1])) {
+		std::cout << "could not open session log " << argv[1] << '\n';
+		return 1;
+	}
+
+	static const char* tierNames[] = { "none", "rules", "pattern", "csp", "guess" };
+	static const int tierCount = sizeof(tierNames) / sizeof(tierNames[0]);
+	TierStats stats[tierCount];
+	int turns = 0;
+	int games = 0;
+	int actionMismatches = 0;
+	int timedOutMismatches = 0;
+	int parseMismatches = 0;
+	double parseMicros = 0;
+
+	// The solver prints progress for every CSP section; keep that out of the timings.
+	std::ostringstream solverOutput;
+	std::streambuf* console = std::cout.rdbuf(solverOutput.rdbuf());
+
+	auto start = std::chrono::steady_clock::now();
+	for (int repeat = 0; repeat < repeats; ++repeat) {
+		BoardParser parser;
+		Solver solver;
+		TurnRecord record;
+		uint32_t lastTurn = 0;
+		std::vector<uint8_t> lastStates;
+		reader.rewind();
+
+		while (reader.next(record)) {
+			// Sections cached in the last game don't hold in this one.
+			if (startsNewGame(record, lastTurn, lastStates)) {
+				solver.newGame();
+				if (repeat == 0)
+					++games;
+			}
+			lastTurn = record.turn;
+			lastStates = record.states;
+
+			auto turnStart = std::chrono::steady_clock::now();
+			bool parsed = false;
+			if (record.hasFrame) {
+				parser.update(reader.returnFrame());
+				parser.parseCells();
+				if (!parser.gameOver) {
+					parser.initParsedBoard();
+					parsed = matchesStates(parser.returnBoard(), record.states);
+				}
+				if (!parsed)
+					++parseMismatches;
+				parser.gameOver = false;
+			}
+			if (!parsed) {
+				parser.loadStates(record.states, record.width, record.height);
+				parser.initParsedBoard();
+			}
+			parseMicros += microsSince(turnStart);
+
+			auto solveStart = std::chrono::steady_clock::now();
+			solver.update(parser.returnBoard(), parser.returnTiles());
+			solver.speculate = record.speculated;
+			solver.totalMines = googleMineCount(record.width, record.height);
+			runTier(solver, record.tier);
+			double solveMicros = microsSince(solveStart);
+
+			if (sortedActions(solver.returnActions()) != sortedActions(record.actions))
+				++(record.timedOut ? timedOutMismatches : actionMismatches);
+
+			TierStats& tierStats = stats[record.tier < tierCount ? record.tier : NO_TIER];
+			tierStats.turns++;
+			tierStats.recordedMicros += record.solveMicros;
+			tierStats.replayedMicros += solveMicros;
+			++turns;
+
+			solverOutput.str("");
+		}
+	}
+	double totalMicros = microsSince(start);
+
+	std::cout.rdbuf(console);
+	std::cout << "replayed " << turns << " turns of " << games << " game(s) (" << repeats << "x) in " << totalMicros / 1000 << " ms, "
+		<< (totalMicros > 0 ? turns / (totalMicros / 1e6) : 0) << " turns/s\n";
+	std::cout << "parse: " << (turns ? parseMicros / turns : 0) << " us/turn, "
+		<< parseMismatches << " frame(s) parsed differently than recorded\n";
+	for (int tier = 0; tier < tierCount; ++tier) {
+		if (stats[tier].turns == 0)
+			continue;
+		std::cout << tierNames[tier] << ": " << stats[tier].turns << " turns, recorded "
+			<< stats[tier].recordedMicros / stats[tier].turns << " us/turn, replayed "
+			<< stats[tier].replayedMicros / stats[tier].turns << " us/turn\n";
+	}
+	std::cout << actionMismatches << " turn(s) emitted different actions than recorded";
+	if (timedOutMismatches > 0)
+		std::cout << ", plus " << timedOutMismatches << " that hit the deadline live";
+	std::cout << '\n';
+
+	return actionMismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,326 @@
+#include <cstring>
+#include "SessionLog.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char logMagic[8] = { 'M', 'S', 'W', 'P', 'L', 'O', 'G', '\0' };
+static const uint32_t logVersion = 1;
+static const size_t headerSize = sizeof(logMagic) + sizeof(uint32_t);
+static const size_t chunkHeaderSize = 2 * sizeof(uint32_t);
+static const uint8_t speculatedBit = 0x80;
+static const uint8_t timedOutBit = 0x40;
+
+// Helpers to append little-endian integers to a payload.
+static void put8(std::vector<uint8_t>& out, uint8_t value) {
+	out.push_back(value);
+}
+
+static void put16(std::vector<uint8_t>& out, uint16_t value) {
+	out.push_back(value & 0xff);
+	out.push_back(value >> 8);
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t value) {
+	for (int i = 0; i < 4; ++i)
+		out.push_back((value >> (8 * i)) & 0xff);
+}
+
+// Helpers to read little-endian integers from a mapped file.
+static uint16_t get16(const uint8_t* in) {
+	return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* in) {
+	return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+SessionRecorder::SessionRecorder() : recordFrames(false) {}
+
+bool SessionRecorder::open(const std::string& path, bool frames) {
+	recordFrames = frames;
+	lastStates.clear();
+
+	// Appending to an existing log is fine, as long as it is one.
+	std::ifstream existing(path, std::ios::binary);
+	bool isNew = true;
+	if (existing) {
+		char header[headerSize];
+		existing.read(header, headerSize);
+		if (existing.gcount() > 0) {
+			if (existing.gcount() != headerSize || std::memcmp(header, logMagic, sizeof(logMagic)) != 0)
+				return false;
+			isNew = false;
+		}
+	}
+	existing.close();
+
+	file.open(path, std::ios::binary | std::ios::app);
+	if (!file)
+		return false;
+
+	if (isNew) {
+		std::vector<uint8_t> header(logMagic, logMagic + sizeof(logMagic));
+		put32(header, logVersion);
+		file.write(reinterpret_cast<const char*>(header.data()), header.size());
+		file.flush();
+	}
+	return true;
+}
+
+bool SessionRecorder::isOpen() const { return file.is_open(); }
+
+TurnRecord SessionRecorder::makeRecord(uint32_t turn, const Solver& solver, const std::vector<std::vector<Cell>>& board) {
+	TurnRecord record;
+	record.turn = turn;
+	record.tier = solver.tier;
+	record.speculated = solver.speculate;
+	record.timedOut = solver.timedOut;
+	record.height = board.size();
+	record.width = record.height ? board[0].size() : 0;
+
+	record.states.reserve(record.width * record.height);
+	for (const auto& row : board)
+		for (const auto& cell : row)
+			record.states.push_back(static_cast<uint8_t>(cell.state));
+
+	record.actions = solver.returnActions();
+	return record;
+}
+
+void SessionRecorder::writeChunk(ChunkType type, const std::vector<uint8_t>& payload) {
+	std::vector<uint8_t> header;
+	put32(header, type);
+	put32(header, payload.size());
+	file.write(reinterpret_cast<const char*>(header.data()), header.size());
+	file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+}
+
+void SessionRecorder::recordTurn(const TurnRecord& record, const BoardImage& img) {
+	if (!file.is_open())
+		return;
+
+	if (recordFrames && img.cellWidth > 0 && !img.pixels.empty()) {
+		// Only cells whose state changed since the last frame are stored, except
+		// for the first frame or after the board size changes.
+		bool full = lastStates.size() != record.states.size();
+		size_t rowBytes = img.cellWidth * 4;
+
+		std::vector<uint8_t> payload;
+		put32(payload, record.turn);
+		put16(payload, img.width);
+		put16(payload, img.height);
+		put16(payload, img.cellWidth);
+		size_t countAt = payload.size();
+		put32(payload, 0);
+
+		uint32_t regions = 0;
+		for (size_t id = 0; id < record.states.size(); ++id) {
+			if (!full && lastStates[id] == record.states[id])
+				continue;
+
+			size_t x = id % record.width;
+			size_t y = id / record.width;
+			put32(payload, id);
+			for (size_t row = 0; row < img.cellWidth; ++row) {
+				size_t py = y * img.cellWidth + row;
+				size_t start = (py * img.width + x * img.cellWidth) * 4;
+				if (py < img.height && start + rowBytes <= img.pixels.size())
+					payload.insert(payload.end(), img.pixels.begin() + start, img.pixels.begin() + start + rowBytes);
+				else
+					payload.insert(payload.end(), rowBytes, 0);
+			}
+			++regions;
+		}
+
+		for (int i = 0; i < 4; ++i)
+			payload[countAt + i] = (regions >> (8 * i)) & 0xff;
+		writeChunk(FRAME_CHUNK, payload);
+		lastStates = record.states;
+	}
+
+	std::vector<uint8_t> payload;
+	put32(payload, record.turn);
+	put8(payload, record.tier | (record.speculated ? speculatedBit : 0) | (record.timedOut ? timedOutBit : 0));
+	put16(payload, record.width);
+	put16(payload, record.height);
+	put32(payload, record.captureMicros);
+	put32(payload, record.parseMicros);
+	put32(payload, record.solveMicros);
+	put32(payload, record.actions.size());
+	payload.insert(payload.end(), record.states.begin(), record.states.end());
+	for (const auto& action : record.actions) {
+		put8(payload, action.type);
+		put16(payload, action.x);
+		put16(payload, action.y);
+	}
+	writeChunk(TURN_CHUNK, payload);
+
+	file.flush();
+}
+
+SessionReader::SessionReader() : data(nullptr), size(0), offset(0), mapping(nullptr) {}
+
+SessionReader::~SessionReader() { close(); }
+
+void SessionReader::close() {
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping)
+		CloseHandle(mapping);
+#else
+	if (data)
+		munmap(const_cast<uint8_t*>(data), size);
+#endif
+	data = nullptr;
+	mapping = nullptr;
+	size = 0;
+	offset = 0;
+}
+
+bool SessionReader::open(const std::string& path) {
+	close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < headerSize) {
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	mapping = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fileHandle);
+	if (!mapping)
+		return false;
+
+	data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < headerSize) {
+		::close(fd);
+		return false;
+	}
+
+	void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data = static_cast<const uint8_t*>(mapped);
+	size = static_cast<size_t>(info.st_size);
+#endif
+
+	if (!data || std::memcmp(data, logMagic, sizeof(logMagic)) != 0 ||
+		get32(data + sizeof(logMagic)) != logVersion) {
+		close();
+		return false;
+	}
+
+	rewind();
+	return true;
+}
+
+void SessionReader::rewind() {
+	offset = headerSize;
+	frame = BoardImage();
+}
+
+const BoardImage& SessionReader::returnFrame() const { return frame; }
+
+void SessionReader::applyFrame(const uint8_t* payload, size_t length) {
+	if (length < 14)
+		return;
+
+	int width = get16(payload + 4);
+	int height = get16(payload + 6);
+	int cellWidth = get16(payload + 8);
+	uint32_t regions = get32(payload + 10);
+	if (cellWidth == 0)
+		return;
+
+	if (frame.width != width || frame.height != height || frame.cellWidth != cellWidth) {
+		frame.width = width;
+		frame.height = height;
+		frame.cellWidth = cellWidth;
+		frame.pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+	}
+
+	int boardWidth = width / cellWidth;
+	size_t rowBytes = cellWidth * 4;
+	size_t regionSize = 4 + rowBytes * cellWidth;
+	const uint8_t* region = payload + 14;
+	for (uint32_t i = 0; i < regions && region + regionSize <= payload + length; ++i, region += regionSize) {
+		uint32_t id = get32(region);
+		size_t x = id % boardWidth;
+		size_t y = id / boardWidth;
+		for (int row = 0; row < cellWidth; ++row) {
+			size_t py = y * cellWidth + row;
+			size_t start = (py * width + x * cellWidth) * 4;
+			if (py < height && start + rowBytes <= frame.pixels.size())
+				std::memcpy(&frame.pixels[start], region + 4 + row * rowBytes, rowBytes);
+		}
+	}
+}
+
+bool SessionReader::next(TurnRecord& record) {
+	record.hasFrame = false;
+
+	while (offset + chunkHeaderSize <= size) {
+		uint32_t type = get32(data + offset);
+		uint32_t length = get32(data + offset + 4);
+		const uint8_t* payload = data + offset + chunkHeaderSize;
+		if (offset + chunkHeaderSize + length > size)
+			return false;
+		offset += chunkHeaderSize + length;
+
+		if (type == FRAME_CHUNK) {
+			applyFrame(payload, length);
+			record.hasFrame = true;
+			continue;
+		}
+		if (type != TURN_CHUNK || length < 25)
+			continue;
+
+		record.turn = get32(payload);
+		record.tier = static_cast<SolverTier>(payload[4] & ~(speculatedBit | timedOutBit));
+		record.speculated = (payload[4] & speculatedBit) != 0;
+		record.timedOut = (payload[4] & timedOutBit) != 0;
+		record.width = get16(payload + 5);
+		record.height = get16(payload + 7);
+		record.captureMicros = get32(payload + 9);
+		record.parseMicros = get32(payload + 13);
+		record.solveMicros = get32(payload + 17);
+		uint32_t actionCount = get32(payload + 21);
+
+		size_t cells = static_cast<size_t>(record.width) * record.height;
+		if (25 + cells + actionCount * 5 > length)
+			return false;
+
+		const uint8_t* states = payload + 25;
+		record.states.assign(states, states + cells);
+
+		record.actions.clear();
+		const uint8_t* action = states + cells;
+		for (uint32_t i = 0; i < actionCount; ++i, action += 5)
+			record.actions.push_back({ static_cast<ActionType>(action[0]), get16(action + 1), get16(action + 3) });
+		return true;
+	}
+	return false;
+}
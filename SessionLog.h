@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "BoardImage.h"
+#include "BoardParser.h"
+#include "Solver.h"
+
+// Session logs are append-only binary files used to diagnose games after the fact
+// and to benchmark the parser and solver offline (see Replay.cpp).
+//
+// Layout, all integers little-endian:
+//   File header:  8-byte magic "MSWPLOG\0", uint32 format version.
+//   Then chunks:  uint32 chunk type, uint32 payload size, payload.
+//
+// A TURN chunk holds one turn: uint32 turn, uint8 tier (the top bit is set if the
+// solver speculated, see Solver::speculate, and the next one if it stopped at the
+// turn's deadline, see Solver::timedOut), uint16 width and height in
+// cells, uint32 capture/parse/solve times in microseconds, uint32 action count, one
+// uint8 State per cell (row-major), then per action uint8 type, uint16 x, uint16 y.
+//
+// An optional FRAME chunk, written just before the TURN chunk of the same turn,
+// holds the captured pixels of every cell whose state changed since the previous
+// frame: uint32 turn, uint16 image width and height in pixels, uint16 cell width,
+// uint32 region count, then per region uint32 cell index and the cell's BGRA pixels.
+
+// Every chunk type in a session log. Readers skip types they don't know.
+enum ChunkType { TURN_CHUNK = 1, FRAME_CHUNK = 2 };
+
+// Everything recorded about a single turn.
+struct TurnRecord {
+	uint32_t turn = 0;					// Turn number, starting from 0.
+	SolverTier tier = NO_TIER;			// Last solver tier run this turn.
+	bool speculated = false;			// Whether solveStep() speculated this turn.
+	bool timedOut = false;				// Whether the solver stopped at the turn's deadline.
+	int width = 0;						// Board width in cells.
+	int height = 0;						// Board height in cells.
+	uint32_t captureMicros = 0;			// Time spent capturing the screen.
+	uint32_t parseMicros = 0;			// Time spent parsing the board image.
+	uint32_t solveMicros = 0;			// Time spent in the solver.
+	std::vector<uint8_t> states;		// One State per cell, row-major.
+	std::vector<GridAction> actions;	// Actions the solver emitted.
+	bool hasFrame = false;				// Whether a FRAME chunk preceded this turn.
+};
+
+// Appends turns to a session log.
+class SessionRecorder {
+public:
+	// Constructor. Doesn't open anything; recordTurn() does nothing until open() succeeds.
+	SessionRecorder();
+
+	// Opens a session log for appending, writing the file header if the file is new.
+	// With 'frames' set, every turn also records the pixels of changed cells.
+	// Returns false if the file can't be opened or isn't a session log.
+	bool open(const std::string& path, bool frames);
+
+	// Returns true if a log is open.
+	bool isOpen() const;
+
+	// Builds a turn record from the parser and solver state after a turn.
+	static TurnRecord makeRecord(uint32_t turn, const Solver& solver, const std::vector<std::vector<Cell>>& board);
+
+	// Appends a turn to the log. 'img' is the captured image, only used when
+	// recording frames. Flushes so the log survives a crash.
+	void recordTurn(const TurnRecord& record, const BoardImage& img);
+
+private:
+	std::ofstream file;					// The open log.
+	bool recordFrames;					// Whether to write FRAME chunks.
+	std::vector<uint8_t> lastStates;	// Cell states of the last recorded frame.
+
+	// Writes one chunk from a finished payload.
+	void writeChunk(ChunkType type, const std::vector<uint8_t>& payload);
+};
+
+// Reads turns back from a session log. The file is memory-mapped and read in place.
+class SessionReader {
+public:
+	// Constructor. Doesn't open anything.
+	SessionReader();
+
+	// Unmaps the file.
+	~SessionReader();
+
+	SessionReader(const SessionReader&) = delete;
+	SessionReader& operator=(const SessionReader&) = delete;
+
+	// Maps a session log and checks its header. Returns false on failure.
+	bool open(const std::string& path);
+
+	// Reads the next turn into 'record', applying any FRAME chunk before it to
+	// the frame returned by returnFrame(). Returns false at the end of the log
+	// or on a truncated chunk, which is how a log cut off mid-write ends.
+	bool next(TurnRecord& record);
+
+	// Returns the captured image as of the last turn read, rebuilt from every
+	// FRAME chunk so far. Only meaningful if the log was recorded with frames.
+	const BoardImage& returnFrame() const;
+
+	// Goes back to the first turn.
+	void rewind();
+
+private:
+	const uint8_t* data;	// Start of the mapped file.
+	size_t size;			// Size of the mapped file in bytes.
+	size_t offset;			// Read position in the mapped file.
+	void* mapping;			// Platform handle for the mapping.
+	BoardImage frame;		// Captured image rebuilt from FRAME chunks.
+
+	// Applies a FRAME chunk's regions to 'frame'.
+	void applyFrame(const uint8_t* payload, size_t length);
+
+	// Releases the mapping, if any.
+	void close();
+};
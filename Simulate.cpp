@@ -0,0 +1,312 @@
+// Offline benchmark that plays simulated games (see Simulator.h) through the
+// parser and solver with the same turn loop as main(). Not part of the Visual
+// Studio project; it needs no screen, so it also builds on Linux:
+//
+//     g++ -std=c++17 -O2 -pthread -o simulate Simulate.cpp Simulator.cpp BoardParser.cpp
+//         BoardImage.cpp Solver.cpp BitBoard.cpp PatternTable.cpp GuessEvaluator.cpp
+//         TurnScheduler.cpp
+//
+// Usage: simulate [games] [width height mines] [seed]
+//        simulate --guess [games] [width height mines] [seed]
+//        simulate --budget [games] [width height mines] [seed]
+//        simulate --scale [turns]
+//
+// Every game is played twice from the same seed, with the solver's speculation
+// off and on, and the two are compared by captures per game and time per game.
+// Live turns wait 100 ms before each capture for the screen to settle, so the
+// end-to-end estimate adds that wait to the measured parse and solve time.
+//
+// --guess lets the solver guess when it is stuck, as the live loop does, and
+// compares picking the safest cell with GuessEvaluator's lookahead by win rate
+// and by turn latency. Both play the same seeds, so the games only one of them
+// won are compared too, with a sign test for whether the gap could be chance.
+//
+// --budget plays with guessing like the live loop, once with the scheduler's
+// usual turn budget and once with practically none, and compares the turn
+// latency percentiles and win rates.
+//
+// --scale instead plays the first turns of one game on boards from 30x16 up to
+// 1000x1000, drawing every turn as an image and parsing it like a capture, and
+// reports the per-turn cost of parsing and solving against the board area.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "BoardParser.h"
+#include "Simulator.h"
+#include "Solver.h"
+#include "TurnScheduler.h"
+
+static const double captureWaitMicros = 100000;
+
+// Turn budget standing in for no budget at all in --budget.
+static const auto unlimitedBudget = std::chrono::hours(24);
+
+// How the solver plays when nothing is certain.
+enum GuessMode { NO_GUESS, SAFEST_GUESS, LOOKAHEAD_GUESS };
+
+// Pixels per cell in the images drawn for --scale. BoardParser reads the
+// middle row of each cell, so this should be even.
+static const int scaleCellWidth = 4;
+
+// Totals for every game played with one setting.
+struct GameStats {
+	int games = 0;
+	int wins = 0;
+	int losses = 0;
+	long long turns = 0;
+	long long captures = 0;
+	double micros = 0;
+	long long guesses = 0;
+	long long timeouts = 0;				// Turns that stopped at the deadline.
+	std::vector<double> turnMicros;		// Time the scheduler took on every turn.
+	std::vector<bool> won;				// Whether each game was won, in the order played.
+};
+
+// Returns the microseconds elapsed since 'start'.
+static double microsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Brings the parsed board up to date the way readBoard() in Minesweeper.cpp does,
+// with the simulator standing in for the screen. Returns false if the game is over.
+static bool readBoard(const Simulator& sim, BoardParser& parser, const Solver& solver, GameStats& stats) {
+	if (!solver.needsCapture()) {
+		std::vector<Coord> flags;
+		for (const auto& action : solver.returnActions())
+			flags.push_back({ action.x, action.y });
+		parser.applyFlags(flags);
+		return true;
+	}
+
+	++stats.captures;
+	if (sim.lost() || sim.won())
+		return false;
+
+	parser.loadStates(sim.returnStates(), sim.width(), sim.height());
+	parser.initParsedBoard();
+	return true;
+}
+
+// Plays one game to the end, or, without guessing, until the solver is stuck.
+// Without guessing, a lost game means the solver made a wrong deduction.
+static void playGame(Simulator& sim, TurnScheduler scheduler, bool speculate, GuessMode guessMode,
+	int width, int height, int mines, unsigned seed, GameStats& stats) {
+	BoardParser parser;
+	Solver solver;
+	solver.speculate = speculate;
+	solver.totalMines = mines;
+	solver.guesser.lookahead = guessMode == LOOKAHEAD_GUESS;
+	scheduler.guess = guessMode != NO_GUESS;
+	sim.newGame(width, height, mines, seed);
+
+	auto start = std::chrono::steady_clock::now();
+	while (solver.progress) {
+		if (!readBoard(sim, parser, solver, stats))
+			break;
+
+		auto turnStart = std::chrono::steady_clock::now();
+		solver.update(parser.returnBoard(), parser.returnTiles());
+		scheduler.run(solver);
+		stats.turnMicros.push_back(microsSince(turnStart));
+		if (solver.tier == GUESS_TIER)
+			stats.guesses++;
+		if (solver.timedOut)
+			stats.timeouts++;
+
+		sim.applyActions(solver.returnActions());
+		++stats.turns;
+	}
+	stats.micros += microsSince(start);
+
+	stats.games++;
+	stats.won.push_back(sim.won());
+	if (sim.won())
+		stats.wins++;
+	else if (sim.lost())
+		stats.losses++;
+}
+
+// Prints the totals for one setting.
+static void printStats(const char* name, const GameStats& stats) {
+	double games = stats.games ? stats.games : 1;
+	std::cout << name << ": " << stats.wins << "/" << stats.games << " won, " << stats.losses << " lost, "
+		<< stats.turns / games << " turns/game, "
+		<< stats.captures / games << " captures/game, "
+		<< stats.micros / games / 1000 << " ms/game solving, ~"
+		<< (stats.micros + stats.captures * captureWaitMicros) / games / 1e6 << " s/game end to end\n";
+}
+
+// Returns the given percentile of 'micros', which it sorts.
+static double percentile(std::vector<double>& micros, double fraction) {
+	if (micros.empty())
+		return 0;
+	std::sort(micros.begin(), micros.end());
+	return micros[std::min(micros.size() - 1, static_cast<size_t>(fraction * micros.size()))];
+}
+
+// Prints the win rate, guesses and turn latency for one setting.
+static void printGuessStats(const char* name, GameStats& stats) {
+	double games = stats.games ? stats.games : 1;
+	std::cout << name << ": " << stats.wins << "/" << stats.games << " won (" << 100.0 * stats.wins / games << "%), "
+		<< stats.guesses / games << " guesses/game, " << stats.timeouts << " turn(s) hit the deadline, turn latency "
+		<< percentile(stats.turnMicros, 0.5) / 1000 << " ms p50, "
+		<< percentile(stats.turnMicros, 0.99) / 1000 << " ms p99, "
+		<< percentile(stats.turnMicros, 0.999) / 1000 << " ms p99.9, "
+		<< percentile(stats.turnMicros, 1) / 1000 << " ms max\n";
+}
+
+// Compares two settings game by game, both played from the same seeds. Only
+// games that one setting won and the other lost tell them apart. Without a
+// real difference, each such game is equally likely to go either way, so
+// the sign test's two-sided p-value (normal approximation) shows whether
+// the split could be chance.
+static void printPaired(const char* firstName, const char* secondName, const GameStats& first, const GameStats& second) {
+	int firstOnly = 0;
+	int secondOnly = 0;
+	for (size_t game = 0; game < first.won.size() && game < second.won.size(); ++game) {
+		if (first.won[game] && !second.won[game])
+			firstOnly++;
+		else if (second.won[game] && !first.won[game])
+			secondOnly++;
+	}
+
+	int split = firstOnly + secondOnly;
+	double z = split ? (secondOnly - firstOnly) / std::sqrt(static_cast<double>(split)) : 0;
+	std::cout << "paired: " << secondOnly << " game(s) won only by " << secondName << ", " << firstOnly
+		<< " only by " << firstName << ", z = " << z << ", p = " << std::erfc(std::fabs(z) / std::sqrt(2.0)) << '\n';
+}
+
+// Per-turn costs measured on one board size.
+struct ScaleStats {
+	int turns = 0;
+	double firstParseMicros = 0;	// Parsing the first turn, which builds every tile.
+	double parseMicros = 0;			// Parsing every later turn.
+	double solveMicros = 0;			// Solving every turn.
+};
+
+// Plays up to 'maxTurns' turns of one game on a board of the given size,
+// parsing a drawn image every turn like a capture.
+static ScaleStats measureScale(int width, int height, int maxTurns) {
+	Simulator sim;
+	BoardParser parser;
+	Solver solver;
+	TurnScheduler scheduler;
+	BoardImage img;
+	ScaleStats stats;
+	scheduler.guess = false;
+	sim.newGame(width, height, width * height * 16 / 100, 1);
+
+	while (stats.turns < maxTurns && solver.progress && !sim.lost() && !sim.won()) {
+		sim.render(img, scaleCellWidth);
+
+		auto start = std::chrono::steady_clock::now();
+		parser.update(img);
+		parser.parseCells();
+		parser.initParsedBoard();
+		(stats.turns == 0 ? stats.firstParseMicros : stats.parseMicros) += microsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		solver.update(parser.returnBoard(), parser.returnTiles());
+		scheduler.run(solver);
+		stats.solveMicros += microsSince(start);
+
+		sim.applyActions(solver.returnActions());
+		stats.turns++;
+	}
+	return stats;
+}
+
+// Prints the per-turn costs for one board size, in total and per cell.
+static void printScale(int width, int height, const ScaleStats& stats) {
+	double cells = static_cast<double>(width) * height;
+	double laterTurns = std::max(stats.turns - 1, 1);
+	double turns = std::max(stats.turns, 1);
+	double parse = stats.parseMicros / laterTurns;
+	double solve = stats.solveMicros / turns;
+	std::cout << width << "x" << height << ": " << stats.turns << " turns, first parse "
+		<< stats.firstParseMicros / 1000 << " ms (" << stats.firstParseMicros * 1000 / cells << " ns/cell), "
+		<< "later parses " << parse / 1000 << " ms (" << parse * 1000 / cells << " ns/cell), "
+		<< "solve " << solve / 1000 << " ms (" << solve * 1000 / cells << " ns/cell)\n";
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && std::string(argv[1]) == "--scale") {
+		int maxTurns = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+		std::cout << "parser workers: " << BoardParser().workers << '\n';
+
+		static const int sizes[][2] = { { 30, 16 }, { 100, 100 }, { 250, 250 }, { 500, 500 }, { 1000, 1000 } };
+		for (const auto& size : sizes) {
+			std::ostringstream solverOutput;
+			std::streambuf* console = std::cout.rdbuf(solverOutput.rdbuf());
+			ScaleStats stats = measureScale(size[0], size[1], maxTurns);
+			std::cout.rdbuf(console);
+			printScale(size[0], size[1], stats);
+		}
+		return 0;
+	}
+
+	std::string mode = argc > 1 ? argv[1] : "";
+	bool guess = mode == "--guess";
+	bool budget = mode == "--budget";
+	int arg = guess || budget ? 2 : 1;
+	int games = argc > arg ? std::atoi(argv[arg]) : 200;
+	int width = argc > arg + 3 ? std::atoi(argv[arg + 1]) : 18;
+	int height = argc > arg + 3 ? std::atoi(argv[arg + 2]) : 14;
+	int mines = argc > arg + 3 ? std::atoi(argv[arg + 3]) : 40;
+	unsigned seed = argc > arg + 4 ? std::atoi(argv[arg + 4]) : 1;
+	if (games < 1 || width < 3 || height < 3 || mines < 0) {
+		std::cout << "usage: simulate [--guess | --budget] [games] [width height mines] [seed]\n";
+		return 1;
+	}
+
+	Simulator sim;
+	TurnScheduler scheduler, unlimited;
+	unlimited.budget = unlimitedBudget;
+	GameStats first, second;
+
+	// The solver prints progress for every CSP section; keep that out of the timings.
+	std::ostringstream solverOutput;
+	std::streambuf* console = std::cout.rdbuf(solverOutput.rdbuf());
+
+	for (int game = 0; game < games; ++game) {
+		if (guess) {
+			playGame(sim, scheduler, true, SAFEST_GUESS, width, height, mines, seed + game, first);
+			playGame(sim, scheduler, true, LOOKAHEAD_GUESS, width, height, mines, seed + game, second);
+		}
+		else if (budget) {
+			playGame(sim, unlimited, true, LOOKAHEAD_GUESS, width, height, mines, seed + game, first);
+			playGame(sim, scheduler, true, LOOKAHEAD_GUESS, width, height, mines, seed + game, second);
+		}
+		else {
+			playGame(sim, scheduler, false, NO_GUESS, width, height, mines, seed + game, first);
+			playGame(sim, scheduler, true, NO_GUESS, width, height, mines, seed + game, second);
+		}
+		solverOutput.str("");
+	}
+
+	std::cout.rdbuf(console);
+	std::cout << games << " games on " << width << "x" << height << " with " << mines << " mines\n";
+	if (guess) {
+		std::cout << "turn budget: " << scheduler.budget.count() / 1000 << " ms, guess workers: " << Solver().guesser.workers << '\n';
+		printGuessStats("safest cell", first);
+		printGuessStats("lookahead  ", second);
+		printPaired("safest cell", "lookahead", first, second);
+	}
+	else if (budget) {
+		std::cout << "guess workers: " << Solver().guesser.workers << '\n';
+		printGuessStats("no budget   ", first);
+		std::ostringstream name;
+		name << scheduler.budget.count() / 1000 << " ms budget";
+		printGuessStats(name.str().c_str(), second);
+	}
+	else {
+		printStats("speculation off", first);
+		printStats("speculation on ", second);
+	}
+	return 0;
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstdlib>
+#include "Simulator.h"
+
+// Colors BoardParser::findState() recognizes, indexed by State. The parser has
+// no color for eights yet, so they are drawn like sevens.
+static const Pixel stateColors[] = {
+	{ 222, 189, 156 },	// ZERO
+	{ 25, 118, 210 },	// ONE
+	{ 56, 142, 60 },	// TWO
+	{ 211, 47, 47 },	// THREE
+	{ 123, 31, 162 },	// FOUR
+	{ 255, 143, 0 },	// FIVE
+	{ 0, 151, 167 },	// SIX
+	{ 66, 66, 66 },		// SEVEN
+	{ 66, 66, 66 },		// EIGHT
+	{ 230, 51, 7 },		// FLAG
+	{ 166, 212, 77 },	// UNKNOWN
+};
+
+Simulator::Simulator() : boardWidth(0), boardHeight(0), mineCount(0), revealed(0), hitMine(false) {}
+
+const std::vector<uint8_t>& Simulator::returnStates() const { return states; }
+
+bool Simulator::lost() const { return hitMine; }
+
+bool Simulator::won() const { return !hitMine && revealed == boardWidth * boardHeight - mineCount; }
+
+int Simulator::width() const { return boardWidth; }
+
+int Simulator::height() const { return boardHeight; }
+
+void Simulator::newGame(int width, int height, int count, unsigned seed) {
+	boardWidth = width;
+	boardHeight = height;
+	rng.seed(seed);
+
+	int startX = width / 2;
+	int startY = height / 2;
+
+	// Every cell outside the 3x3 area around the first click can hold a mine.
+	std::vector<int> candidates;
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			if (std::abs(x - startX) > 1 || std::abs(y - startY) > 1)
+				candidates.push_back(y * width + x);
+	std::shuffle(candidates.begin(), candidates.end(), rng);
+
+	mineCount = std::min(count, static_cast<int>(candidates.size()));
+	mines.assign(static_cast<size_t>(width) * height, 0);
+	for (int i = 0; i < mineCount; ++i)
+		mines[candidates[i]] = 1;
+
+	states.assign(static_cast<size_t>(width) * height, UNKNOWN);
+	revealed = 0;
+	hitMine = false;
+	reveal(startX, startY);
+}
+
+int Simulator::adjacentMines(int x, int y) const {
+	int count = 0;
+	for (int dy = -1; dy < 2; ++dy) {
+		for (int dx = -1; dx < 2; ++dx) {
+			int nx = x + dx;
+			int ny = y + dy;
+			if (nx < 0 || nx >= boardWidth || ny < 0 || ny >= boardHeight)
+				continue;
+			count += mines[ny * boardWidth + nx];
+		}
+	}
+	return count;
+}
+
+void Simulator::reveal(int x, int y) {
+	std::vector<std::pair<int, int>> pending = { { x, y } };
+	while (!pending.empty()) {
+		int cx = pending.back().first;
+		int cy = pending.back().second;
+		pending.pop_back();
+
+		size_t id = static_cast<size_t>(cy) * boardWidth + cx;
+		if (states[id] != UNKNOWN)
+			continue;
+
+		if (mines[id]) {
+			hitMine = true;
+			return;
+		}
+
+		int count = adjacentMines(cx, cy);
+		states[id] = static_cast<uint8_t>(count);
+		++revealed;
+		if (count != 0)
+			continue;
+
+		for (int dy = -1; dy < 2; ++dy) {
+			for (int dx = -1; dx < 2; ++dx) {
+				int nx = cx + dx;
+				int ny = cy + dy;
+				if (nx >= 0 && nx < boardWidth && ny >= 0 && ny < boardHeight)
+					pending.push_back({ nx, ny });
+			}
+		}
+	}
+}
+
+void Simulator::applyActions(const std::vector<GridAction>& actions) {
+	for (const auto& action : actions) {
+		if (hitMine)
+			return;
+
+		size_t id = action.y * boardWidth + action.x;
+		if (action.type == RCLICK) {
+			if (states[id] == UNKNOWN)
+				states[id] = FLAG;
+		}
+		else {
+			reveal(static_cast<int>(action.x), static_cast<int>(action.y));
+		}
+	}
+}
+
+void Simulator::drawCell(BoardImage& img, int x, int y) const {
+	State state = static_cast<State>(states[static_cast<size_t>(y) * boardWidth + x]);
+
+	// Numbers are drawn on a revealed background and flags on an unrevealed one,
+	// with their own color across the middle of the middle row, like on screen.
+	const Pixel& background = stateColors[(state == FLAG || state == UNKNOWN) ? UNKNOWN : ZERO];
+	const Pixel& mark = stateColors[state];
+	int cellWidth = img.cellWidth;
+	for (int row = 0; row < cellWidth; ++row) {
+		size_t start = (static_cast<size_t>(y * cellWidth + row) * img.width + static_cast<size_t>(x) * cellWidth) * 4;
+		for (int col = 0; col < cellWidth; ++col) {
+			bool marked = row == cellWidth / 2 && col >= cellWidth / 4 && col < cellWidth - cellWidth / 4;
+			const Pixel& color = marked ? mark : background;
+			uint8_t* pixel = &img.pixels[start + static_cast<size_t>(col) * 4];
+			pixel[0] = static_cast<uint8_t>(color.b);
+			pixel[1] = static_cast<uint8_t>(color.g);
+			pixel[2] = static_cast<uint8_t>(color.r);
+			pixel[3] = 255;
+		}
+	}
+}
+
+void Simulator::render(BoardImage& img, int cellWidth) {
+	bool full = img.width != boardWidth * cellWidth || img.height != boardHeight * cellWidth ||
+		img.cellWidth != cellWidth || drawn.size() != states.size();
+	if (full) {
+		img.width = boardWidth * cellWidth;
+		img.height = boardHeight * cellWidth;
+		img.cellWidth = cellWidth;
+		img.pixels.assign(static_cast<size_t>(img.width) * img.height * 4, 0);
+	}
+
+	for (int y = 0; y < boardHeight; ++y) {
+		for (int x = 0; x < boardWidth; ++x) {
+			size_t id = static_cast<size_t>(y) * boardWidth + x;
+			if (full || drawn[id] != states[id])
+				drawCell(img, x, y);
+		}
+	}
+	drawn = states;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "BoardImage.h"
+#include "BoardParser.h"
+#include "Solver.h"
+
+// An in-memory Minesweeper game that stands in for the screen, so the solver
+// can be run and measured offline (see Simulate.cpp). Cell states use the same
+// values as the parser, so returnStates() can go straight into BoardParser::loadStates().
+class Simulator {
+public:
+	// Constructor. Starts with an empty 0x0 board.
+	Simulator();
+
+	// Starts a new game with mines placed at random. Like Google's Minesweeper, the
+	// first click, in the center of the board, never has a mine around it, so it
+	// always opens an area. The first click is made here.
+	void newGame(int width, int height, int mineCount, unsigned seed);
+
+	// Applies grid actions the way clicking them on screen would: left clicks reveal
+	// a cell, opening the area around it if it is a zero, and right clicks flag it.
+	void applyActions(const std::vector<GridAction>& actions);
+
+	// Returns the state of every cell as the player sees it, row-major.
+	const std::vector<uint8_t>& returnStates() const;
+
+	// Draws the board into 'img' the way BoardParser expects to see it on screen,
+	// 'cellWidth' pixels per cell. If 'img' was last drawn by this call at the same
+	// size, only the cells that changed since then are redrawn.
+	void render(BoardImage& img, int cellWidth);
+
+	bool lost() const;		// Whether a mine was revealed.
+	bool won() const;		// Whether every safe cell was revealed.
+	int width() const;		// Number of cells horizontally.
+	int height() const;		// Number of cells vertically.
+
+private:
+	int boardWidth;					// Number of cells horizontally.
+	int boardHeight;				// Number of cells vertically.
+	int mineCount;					// Number of mines on the board.
+	std::vector<uint8_t> mines;		// One entry per cell, 1 if it holds a mine.
+	std::vector<uint8_t> states;	// One State per cell, as the player sees it.
+	std::vector<uint8_t> drawn;		// State of every cell as of the last render().
+	int revealed;					// Number of safe cells revealed so far.
+	bool hitMine;					// Whether a mine was revealed.
+	std::mt19937 rng;				// Source of mine placements.
+
+	// Returns the number of mines around cell (x, y).
+	int adjacentMines(int x, int y) const;
+
+	// Reveals cell (x, y), and every cell around it while revealing zeros.
+	void reveal(int x, int y);
+
+	// Draws cell (x, y) into 'img'.
+	void drawCell(BoardImage& img, int x, int y) const;
+};
@@ -1,102 +1,213 @@
 #include <iostream>
 #include "Solver.h"
 
+int googleMineCount(size_t width, size_t height) {
+	if (width == 10 && height == 8)
+		return 10;
+	if (width == 18 && height == 14)
+		return 40;
+	if (width == 24 && height == 20)
+		return 99;
+	return 0;
+}
+
 Solver::Solver() {
+	parsedBoard = nullptr;
+	boardTiles = nullptr;
 	progress = true;
+	tier = NO_TIER;
+	speculate = true;
+	rounds = 0;
+	totalMines = 0;
+	timedOut = false;
+}
+
+void Solver::update(const std::vector<std::vector<Cell>>& pBoard, const std::vector<BoardTile>& pTiles) {
+	parsedBoard = &pBoard;
+	boardTiles = &pTiles;
+	timedOut = false;
 }
 
-void Solver::update(std::vector<std::vector<Cell>> pBoard) { parsedBoard = pBoard; }
+void Solver::newGame() {
+	progress = true;
+	tier = NO_TIER;
+	gridActions.clear();
+	sectionCache.clear();
+	cachedCellBits.clear();
+	pendingSections.clear();
+}
 
 const std::vector<GridAction>& Solver::returnActions() const { return gridActions; }
 
-std::unordered_set<Coord, CoordHash> Solver::findMines() {
-	std::unordered_set<Coord, CoordHash> toClick;
-	for (const auto& row : parsedBoard) {
-		for (const auto& cell : row) {
-			if (cell.state == FLAG || cell.state == UNKNOWN)
-				continue;
-			if (cell.adjacentUnknowns == 0)
-				continue;
+bool Solver::needsCapture() const {
+	if (!speculate || gridActions.empty())
+		return true;
+	return std::any_of(gridActions.begin(), gridActions.end(),
+		[](const GridAction& action) { return action.type == LCLICK; });
+}
 
-			if (cell.adjacentUnknowns + cell.adjacentFlags == cell.state) {
-				progress = true;
-				for (const auto& neighbor : cell.neighbors) {
-					toClick.insert({ neighbor.x, neighbor.y });
-				}
-			}
-		}
+void Solver::bitsToActions(const std::vector<uint64_t>& bits, ActionType type) {
+	forcedCells.clear();
+	bitboard.collectCells(bits, forcedCells);
+	for (const auto& cell : forcedCells)
+		gridActions.push_back({ type, cell.x, cell.y });
+}
+
+void Solver::solveStep() {
+	progress = false;
+	tier = RULES_TIER;
+	rounds = 0;
+	gridActions.clear();
+
+	bitboard.load(*parsedBoard);
+	while (true) {
+		bitboard.findMoves(mineBits, safeBits);
+
+		size_t found = gridActions.size();
+		bitsToActions(mineBits, RCLICK);
+		bitsToActions(safeBits, LCLICK);
+		if (gridActions.size() == found)
+			break;
+		++rounds;
+
+		// New flags can satisfy a number, and cells about to be revealed can't be
+		// mines, so the moves just found may force more without a new capture.
+		if (!speculate)
+			break;
+		bitboard.applyMoves(mineBits, safeBits);
 	}
-	return toClick;
+	progress = !gridActions.empty();
 }
 
-std::unordered_set<Coord, CoordHash> Solver::findSafeCells() {
-	std::unordered_set<Coord, CoordHash> toClick;
-	for (const auto& row : parsedBoard) {
-		for (const auto& cell : row) {
-			if (cell.state == FLAG || cell.state == UNKNOWN || cell.state == ZERO)
-				continue;
-			if (cell.adjacentUnknowns == 0)
+// Returns true if 'coord' is one of the eight cells around 'cell'.
+static bool isAdjacent(const Coord& coord, const Cell& cell) {
+	long long dx = static_cast<long long>(coord.x) - static_cast<long long>(cell.x);
+	long long dy = static_cast<long long>(coord.y) - static_cast<long long>(cell.y);
+	return dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1;
+}
+
+// Returns true if the cell is a number that can't be solved on its own:
+// it still needs mines, but not as many as it has unknown neighbors.
+static bool isPatternCandidate(const Cell& cell) {
+	if (cell.state == ZERO || cell.state == FLAG || cell.state == UNKNOWN)
+		return false;
+	int minesLeft = cell.state - cell.adjacentFlags;
+	return minesLeft > 0 && minesLeft < cell.adjacentUnknowns;
+}
+
+void Solver::patternStep() {
+	progress = false;
+	tier = PATTERN_TIER;
+	gridActions.clear();
+
+	std::unordered_set<Coord, CoordHash> mineSet;
+	std::unordered_set<Coord, CoordHash> safeSet;
+
+	int height = parsedBoard->size();
+	int width = height ? (*parsedBoard)[0].size() : 0;
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const Cell& first = (*parsedBoard)[y][x];
+			if (!isPatternCandidate(first))
 				continue;
 
-			if (cell.adjacentFlags == cell.state) {
-				progress = true;
-				for (const auto& neighbor : cell.neighbors) {
-					toClick.insert({ neighbor.x, neighbor.y });
+			// Numbers can share unknown neighbors up to two cells apart. Only look
+			// forward in row-major order so every pair is matched once.
+			for (int dy = 0; dy <= 2; ++dy) {
+				for (int dx = -2; dx <= 2; ++dx) {
+					if (dy == 0 && dx <= 0)
+						continue;
+					int nx = x + dx;
+					int ny = y + dy;
+					if (nx < 0 || nx >= width || ny >= height)
+						continue;
+
+					const Cell& second = (*parsedBoard)[ny][nx];
+					if (!isPatternCandidate(second))
+						continue;
+
+					int shared = 0;
+					for (const auto& nbr : first.neighbors)
+						if (isAdjacent(nbr, second))
+							++shared;
+					if (shared == 0)
+						continue;
+
+					uint16_t key = patternKey(first.adjacentUnknowns - shared, shared,
+						second.adjacentUnknowns - shared,
+						first.state - first.adjacentFlags, second.state - second.adjacentFlags);
+					uint8_t result = lookupPattern(key);
+					if (result == 0)
+						continue;
+
+					// Shared cells are checked through the first number's neighbors.
+					for (const auto& nbr : first.neighbors) {
+						PatternResult forced = regionResult(result, isAdjacent(nbr, second) ? SHARED : FIRST_ONLY);
+						if (forced == FORCED_MINE)
+							mineSet.insert(nbr);
+						else if (forced == FORCED_SAFE)
+							safeSet.insert(nbr);
+					}
+					for (const auto& nbr : second.neighbors) {
+						if (isAdjacent(nbr, first))
+							continue;
+						PatternResult forced = regionResult(result, SECOND_ONLY);
+						if (forced == FORCED_MINE)
+							mineSet.insert(nbr);
+						else if (forced == FORCED_SAFE)
+							safeSet.insert(nbr);
+					}
 				}
 			}
 		}
 	}
-	return toClick;
-}
 
-void Solver::solveStep() {
-	progress = false;
-	gridActions.clear();
-	
-	const auto& mines = findMines();
-	for (const auto& mine : mines)
+	for (const auto& mine : mineSet)
 		gridActions.push_back({ RCLICK, mine.x, mine.y });
-	const auto& safeCells = findSafeCells();
-	for (const auto& cell : safeCells)
+	for (const auto& cell : safeSet)
 		gridActions.push_back({ LCLICK, cell.x, cell.y });
+	progress = !gridActions.empty();
 }
 
 void Solver::collectFrontier() {
 	frontierCells.clear();
-	for (const auto& row : parsedBoard) {
-		for (const auto& cell : row) {
-			if (cell.frontier)
-				frontierCells.push_back({ cell.x, cell.y });
-		}
-	}
+	for (const auto& tile : *boardTiles)
+		frontierCells.insert(frontierCells.end(), tile.frontier.begin(), tile.frontier.end());
 }
 
 void Solver::collectConstraints() {
-	std::unordered_map<Coord, int, CoordHash> coordToIndex;
+	size_t height = parsedBoard->size();
+	size_t width = height ? (*parsedBoard)[0].size() : 0;
+	if (frontierIndex.size() != width * height)
+		frontierIndex.assign(width * height, -1);
+
 	for (int i = 0; i < frontierCells.size(); ++i)
-		coordToIndex[frontierCells[i]] = i;
+		frontierIndex[frontierCells[i].y * width + frontierCells[i].x] = i;
 
 	constraints.clear();
 
-	for (const auto& row : parsedBoard) {
-		for (const auto& cell : row) {
-			if (cell.state == ZERO || cell.state == FLAG || cell.state == UNKNOWN)
-				continue;
+	for (const auto& tile : *boardTiles) {
+		for (const auto& coord : tile.numbers) {
+			const Cell& cell = (*parsedBoard)[coord.y][coord.x];
 
 			Constraint c;
 			c.mines = cell.state - cell.adjacentFlags;
 
 			for (const auto& nbr : cell.neighbors) {
-				auto it = coordToIndex.find(nbr);
-				if (it != coordToIndex.end()) {
-					c.vars.push_back(it->second);
-				}
+				int index = frontierIndex[nbr.y * width + nbr.x];
+				if (index >= 0)
+					c.vars.push_back(index);
 			}
 
 			if (!c.vars.empty())
 				constraints.push_back(c);
 		}
 	}
+
+	// Only the frontier was written, so only it needs clearing for the next turn.
+	for (const auto& coord : frontierCells)
+		frontierIndex[coord.y * width + coord.x] = -1;
 }
 
 void Solver::findSections() {
@@ -136,22 +247,120 @@ void Solver::findSections() {
 	}
 }
 
-void Solver::solveSections() {
+// Number of assignments enumerated between checks of the deadline; a few
+// tens of microseconds of work on the largest sections.
+static const size_t deadlineCheckMasks = 4096;
+
+// Sections with more valid assignments than this are not cached; filtering them
+// next turn would cost about as much memory and time as solving them again.
+static const size_t maxCachedSolutions = 1 << 20;
+
+bool Solver::filterCachedSection(const std::vector<int>& vars, const std::vector<Constraint>& cons,
+	const std::unordered_map<int, int>& globalToLocal, std::vector<uint32_t>& solutions) {
+	auto first = cachedCellBits.find(frontierCells[vars[0]]);
+	if (first == cachedCellBits.end())
+		return false;
+
+	int cacheId = first->second.first;
+	const SectionCache& cached = sectionCache[cacheId];
+
+	// Every cell must come from the same cached section.
+	int N = vars.size();
+	std::vector<int> cachedBit(N);
+	uint32_t keptBits = 0;
+	for (int i = 0; i < N; ++i) {
+		auto it = cachedCellBits.find(frontierCells[vars[i]]);
+		if (it == cachedCellBits.end() || it->second.first != cacheId)
+			return false;
+		cachedBit[i] = it->second.second;
+		keptBits |= 1u << cachedBit[i];
+	}
+
+	// Cells that left the section must have been flagged or revealed since.
+	uint32_t fixedBits = 0;
+	uint32_t fixedMines = 0;
+	for (int bit = 0; bit < cached.vars.size(); ++bit) {
+		if (keptBits & (1u << bit))
+			continue;
+		const Coord& coord = cached.vars[bit];
+		State state = (*parsedBoard)[coord.y][coord.x].state;
+		if (state == UNKNOWN)
+			return false;
+
+		fixedBits |= 1u << bit;
+		if (state == FLAG)
+			fixedMines |= 1u << bit;
+	}
+
+	// Constraints the cached solutions already satisfy don't need checking again.
+	std::vector<std::pair<uint32_t, int>> newCons;
+	for (const auto& c : cons) {
+		uint32_t bits = 0;
+		for (int v : c.vars)
+			bits |= 1u << cachedBit[globalToLocal.at(v)];
+		if (!cached.constraints.count({ bits, c.mines }))
+			newCons.push_back({ bits, c.mines });
+	}
+
+	solutions.clear();
+	for (uint32_t solution : cached.solutions) {
+		if ((solution & fixedBits) != fixedMines)
+			continue;
+
+		bool valid = true;
+		for (const auto& [bits, mines] : newCons) {
+			if (countBits(solution & bits) != mines) {
+				valid = false;
+				break;
+			}
+		}
+		if (!valid) continue;
+
+		uint32_t local = 0;
+		for (int i = 0; i < N; ++i)
+			local |= ((solution >> cachedBit[i]) & 1u) << i;
+		solutions.push_back(local);
+	}
+
+	// An empty result means the board contradicts the cache (e.g. a misread cell),
+	// so let the caller solve from scratch rather than trust it.
+	return !solutions.empty();
+}
+
+void Solver::solveSections(std::chrono::steady_clock::time_point deadline) {
 	mines.clear();
 	safeCells.clear();
 	progress = false;
 
+	std::vector<SectionCache> newCache;
+	std::vector<SectionProgress> newPending;
+
+	// Nothing to solve if no unknown cell touches a number, e.g. when the
+	// only unknown cells left are walled in by flags.
+	if (sects.empty()) {
+		sectionCache.clear();
+		cachedCellBits.clear();
+		pendingSections.clear();
+		return;
+	}
+
 	int maxSectId = *std::max_element(sects.begin(), sects.end());
 	int numSects = maxSectId + 1;
 
-	for (int sid = 0; sid < numSects; ++sid) {
-		std::vector<int> vars;
-		std::vector<Constraint> cons;
+	// Solving the smallest sections first gets the most moves in before the deadline.
+	std::vector<std::vector<int>> sectVars(numSects);
+	for (int i = 0; i < frontierCells.size(); ++i)
+		sectVars[sects[i]].push_back(i);
 
-		for (int i = 0; i < frontierCells.size(); ++i) {
-			if (sects[i] == sid)
-				vars.push_back(i);
-		}
+	std::vector<int> order(numSects);
+	for (int sid = 0; sid < numSects; ++sid)
+		order[sid] = sid;
+	std::stable_sort(order.begin(), order.end(),
+		[&](int a, int b) { return sectVars[a].size() < sectVars[b].size(); });
+
+	for (int sid : order) {
+		const std::vector<int>& vars = sectVars[sid];
+		std::vector<Constraint> cons;
 
 		int N = vars.size();
 		if (N > 30) {
@@ -174,54 +383,120 @@ void Solver::solveSections() {
 		for (int i = 0; i < N; ++i)
 			globalToLocal[vars[i]] = i;
 
-		std::vector<std::vector<int>> varToCons(N);
-		for (int ci = 0; ci < C; ++ci) {
-			for (int v : cons[ci].vars) {
-				int local = globalToLocal[v];
-				varToCons[local].push_back(ci);
-			}
+		SectionCache entry;
+		for (int v : vars)
+			entry.vars.push_back(frontierCells[v]);
+		for (const auto& c : cons) {
+			uint32_t bits = 0;
+			for (int v : c.vars)
+				bits |= 1u << globalToLocal[v];
+			entry.constraints.insert({ bits, c.mines });
 		}
 
-		std::vector<int> assignment(N, 0);
-		std::vector<int> constraintCount(C, 0);
 		std::vector<int> mineCount(N, 0);
 		int numValidAssignments = 0;
+		std::vector<uint32_t> solutions;
+		bool cacheable = true;
+		bool cutShort = false;
+		size_t startMask = 0;
+
+		bool reused = filterCachedSection(vars, cons, globalToLocal, solutions);
+		if (reused) {
+			for (uint32_t solution : solutions) {
+				numValidAssignments++;
+				for (int i = 0; i < N; ++i)
+					mineCount[i] += (solution >> i) & 1u;
+			}
+		}
+		else {
+			std::vector<std::vector<int>> varToCons(N);
+			for (int ci = 0; ci < C; ++ci) {
+				for (int v : cons[ci].vars) {
+					int local = globalToLocal[v];
+					varToCons[local].push_back(ci);
+				}
+			}
 
-		size_t totalMasks = 1 << N;
-		int prevGray = 0;
+			std::vector<int> assignment(N, 0);
+			std::vector<int> constraintCount(C, 0);
+
+			size_t totalMasks = 1 << N;
+			int prevGray = 0;
+
+			// Pick up where an earlier turn's deadline left this section, if it hasn't changed.
+			auto pending = std::find_if(pendingSections.begin(), pendingSections.end(),
+				[&](const SectionProgress& p) {
+					return p.section.vars == entry.vars && p.section.constraints == entry.constraints;
+				});
+			if (pending != pendingSections.end()) {
+				startMask = pending->nextMask;
+				mineCount = std::move(pending->mineCount);
+				numValidAssignments = pending->validAssignments;
+				solutions = std::move(pending->section.solutions);
+				cacheable = pending->cacheable;
+
+				prevGray = static_cast<int>((startMask - 1) ^ ((startMask - 1) >> 1));
+				for (int i = 0; i < N; ++i)
+					assignment[i] = (prevGray >> i) & 1;
+				for (int ci = 0; ci < C; ++ci)
+					for (int v : cons[ci].vars)
+						constraintCount[ci] += assignment[globalToLocal[v]];
+			}
 
-		for (size_t mask = 0; mask < totalMasks; ++mask) {
-			int gray = mask ^ (mask >> 1);
+			for (size_t mask = startMask; mask < totalMasks; ++mask) {
+				if (mask > startMask && mask % deadlineCheckMasks == 0 && std::chrono::steady_clock::now() >= deadline) {
+					cutShort = true;
+					timedOut = true;
+					startMask = mask;
+					break;
+				}
 
-			if (mask > 0) {
-				int diff = gray ^ prevGray;
-				unsigned long index;
-				_BitScanForward(&index, diff);
-				int flipped = static_cast<int>(index);
+				int gray = mask ^ (mask >> 1);
 
-				int newValue = (gray >> flipped) & 1;
-				int delta = newValue ? 1 : -1;
+				if (mask > 0) {
+					int diff = gray ^ prevGray;
+					int flipped = lowestBit(diff);
 
-				assignment[flipped] = newValue;
+					int newValue = (gray >> flipped) & 1;
+					int delta = newValue ? 1 : -1;
 
-				for (int ci : varToCons[flipped])
-					constraintCount[ci] += delta;
-			}
+					assignment[flipped] = newValue;
 
-			prevGray = gray;
+					for (int ci : varToCons[flipped])
+						constraintCount[ci] += delta;
+				}
 
-			bool valid = true;
-			for (int ci = 0; ci < C; ++ci) {
-				if (constraintCount[ci] != cons[ci].mines) {
-					valid = false;
-					break;
+				prevGray = gray;
+
+				bool valid = true;
+				for (int ci = 0; ci < C; ++ci) {
+					if (constraintCount[ci] != cons[ci].mines) {
+						valid = false;
+						break;
+					}
 				}
+				if (!valid) continue;
+
+				numValidAssignments++;
+				for (int i = 0; i < N; ++i)
+					mineCount[i] += assignment[i];
+
+				if (solutions.size() < maxCachedSolutions)
+					solutions.push_back(gray);
+				else
+					cacheable = false;
 			}
-			if (!valid) continue;
+		}
 
-			numValidAssignments++;
-			for (int i = 0; i < N; ++i)
-				mineCount[i] += assignment[i];
+		// A section cut short proves nothing yet. It is kept to be resumed next
+		// turn, which counts as progress so the turn doesn't fall through to a guess.
+		if (cutShort) {
+			std::cout << "Section " << sid << " has " << N << " vars, put aside at the deadline after "
+				<< startMask << " of " << (1ULL << N) << " assignments\n";
+			entry.solutions = std::move(solutions);
+			newPending.push_back({ std::move(entry), startMask, std::move(mineCount), numValidAssignments, cacheable });
+			progress = true;
+			continue;
 		}
 
 		for (int i = 0; i < N; ++i) {
@@ -239,7 +514,22 @@ void Solver::solveSections() {
 			}
 		}
 
-		std::cout << "Section " << sid << " has " << N << " vars, " << cons.size() << " constraints\n";
+		if (cacheable && numValidAssignments > 0) {
+			entry.solutions = std::move(solutions);
+			newCache.push_back(std::move(entry));
+		}
+
+		std::cout << "Section " << sid << " has " << N << " vars, " << cons.size() << " constraints"
+			<< (reused ? " (filtered from last turn)" : startMask > 0 ? " (resumed from last turn)" : "") << '\n';
+	}
+
+	sectionCache = std::move(newCache);
+	pendingSections = std::move(newPending);
+	cachedCellBits.clear();
+	for (int id = 0; id < sectionCache.size(); ++id) {
+		const auto& cellsInSection = sectionCache[id].vars;
+		for (int bit = 0; bit < cellsInSection.size(); ++bit)
+			cachedCellBits[cellsInSection[bit]] = { id, bit };
 	}
 }
 
@@ -255,12 +545,29 @@ void Solver::CSPGridActions() {
 	}
 }
 
-void Solver::CSPTurn() {
+void Solver::CSPTurn(std::chrono::steady_clock::time_point deadline) {
+	tier = CSP_TIER;
 	collectFrontier();
 	collectConstraints();
 
 	findSections();
-	solveSections();
+	solveSections(deadline);
 
 	CSPGridActions();
-}
\ No newline at end of file
+}
+
+void Solver::guessStep(std::chrono::steady_clock::time_point deadline) {
+	progress = false;
+	tier = GUESS_TIER;
+	gridActions.clear();
+
+	bitboard.load(*parsedBoard);
+	Coord guess;
+	bool chosen = guesser.choose(bitboard, sectionCache, totalMines, deadline, guess);
+	timedOut = timedOut || guesser.timedOut;
+	if (!chosen)
+		return;
+
+	gridActions.push_back({ LCLICK, guess.x, guess.y });
+	progress = true;
+}
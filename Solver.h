@@ -1,18 +1,25 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
-#include <intrin.h>
 #include <set>
 #include <stack>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include "BitBoard.h"
+#include "Bits.h"
 #include "BoardParser.h"
+#include "GuessEvaluator.h"
+#include "PatternTable.h"
 
 // Left click or right click. Left click reveals a cell, right click flags it.
 enum ActionType { LCLICK, RCLICK };
 
+// The parts of the solver, from cheapest to most expensive.
+enum SolverTier { NO_TIER, RULES_TIER, PATTERN_TIER, CSP_TIER, GUESS_TIER };
+
 // Represents a single click, left or right, at a single cell's coordinates.
 struct GridAction {
 	ActionType type;
@@ -27,38 +34,102 @@ struct Constraint {
 	int mineCounter = 0;
 };
 
+// Every valid mine assignment of a section solved on an earlier CSP turn. Lets a
+// section that has only gained constraints be filtered instead of re-enumerated.
+struct SectionCache {
+	std::vector<Coord> vars;						// Cells of the section; bit i of an assignment is vars[i].
+	std::vector<uint32_t> solutions;				// Every valid assignment, one bit per cell.
+	std::set<std::pair<uint32_t, int>> constraints;	// Constraints every solution satisfies, as (cell bits, mines).
+};
+
+// A section whose enumeration stopped at a deadline, kept so that the next CSP
+// turn can pick up where it left off if the section is still the same.
+struct SectionProgress {
+	SectionCache section;		// Cells and constraints of the section, and the valid assignments found so far.
+	size_t nextMask;			// First mask of the enumeration not tried yet.
+	std::vector<int> mineCount;	// Number of valid assignments found so far with each cell a mine.
+	int validAssignments;		// Number of valid assignments found so far.
+	bool cacheable;				// Whether 'section.solutions' holds every valid assignment found so far.
+};
+
+// Returns the number of mines on a Google Minesweeper board of the given
+// size, or 0 if it is not one of the three difficulties.
+int googleMineCount(size_t width, size_t height);
+
 // Applies basic deterministic Minesweeper logic to find guaranteed moves,
-// and saves those moves in a list. Does not guess.
+// and saves those moves in a list. Only guesses when guessStep() is called.
 class Solver {
 public:
-	// Constructor; initializes 'progress' to true.
+	// Constructor; initializes 'progress' and 'speculate' to true and 'tier' to NO_TIER.
 	Solver();
 
-	// Updates the internal parsed board with a new one.
-	void update(std::vector<std::vector<Cell>> pBoard);
+	// Points the solver at a newly parsed board and its tiles. Both are read in place,
+	// not copied, so they must stay alive and unchanged until the turn is solved.
+	void update(const std::vector<std::vector<Cell>>& pBoard, const std::vector<BoardTile>& pTiles);
+
+	// Forgets the sections cached or put aside on earlier turns and resets 'progress' and
+	// 'tier', so a new game can be played on the same solver.
+	void newGame();
 
 	// Returns a list of grid actions to be applied.
 	const std::vector<GridAction>& returnActions() const;
 
+	// Returns true if the board has to be captured again to see what the last actions
+	// did. With 'speculate' set, a turn that only placed flags revealed nothing, so
+	// the flags can be applied to the parsed board instead (BoardParser::applyFlags()).
+	bool needsCapture() const;
+
 	// Finds every guaranteed mine and safe cell in the current parsed board,
-	// then updates 'gridActions' accordingly
+	// then updates 'gridActions' accordingly. Evaluates the single-cell rules
+	// for the whole board at once on a BitBoard. With 'speculate' set, the moves
+	// found are applied to the BitBoard and the rules run again, round after
+	// round, until nothing new is forced, so one capture yields every move that
+	// doesn't depend on what the revealed cells will show.
 	void solveStep();
 
-	bool progress;	// Represents whether or not the solver made any progress in a turn.
-
-	void CSPTurn();
+	// Matches every pair of nearby number cells against the precomputed pattern
+	// table and updates 'gridActions' with the cells they force. Meant for turns
+	// where solveStep() made no progress, before falling back to CSPTurn().
+	void patternStep();
+
+	// Reveals the cell picked by 'guesser' when nothing is certain. Uses the sections
+	// solved by the last CSPTurn(), so it must run on the same board right after it.
+	// No new lookahead trial starts after 'deadline'.
+	void guessStep(std::chrono::steady_clock::time_point deadline);
+
+	// Splits the frontier into independent sections and enumerates every assignment
+	// of each, smallest section first, to find the cells that are mines or safe in
+	// all of them. A section still being enumerated at 'deadline' is put aside,
+	// setting 'timedOut', and the moves of the sections already solved are kept.
+	// Sections too small to check the deadline in are always finished. The next
+	// CSPTurn() resumes a section put aside if it hasn't changed, and if no other
+	// section forced anything, 'progress' is still set, with no actions, since the
+	// enumeration moved on.
+	// (max) is parenthesized so the max() macro from <windows.h> can't expand it.
+	void CSPTurn(std::chrono::steady_clock::time_point deadline = (std::chrono::steady_clock::time_point::max)());
+
+	bool progress;		// Represents whether or not the solver made any progress in a turn.
+	SolverTier tier;	// The last tier the solver ran this turn.
+	bool speculate;		// Whether solveStep() keeps deducing on its own moves; on by default.
+	int rounds;			// Number of rule rounds solveStep() ran this turn that forced something.
+	int totalMines;		// Mines on the whole board if known, 0 if not. Only used by guessStep().
+	bool timedOut;		// Whether CSPTurn() or guessStep() stopped early at its deadline this turn.
+	GuessEvaluator guesser;	// Picks the cell guessStep() reveals.
 
 private:	
-	std::vector<std::vector<Cell>> parsedBoard;	// Parsed grid of cell data
+	const std::vector<std::vector<Cell>>* parsedBoard;	// Parsed grid of cell data, owned by the parser
+	const std::vector<BoardTile>* boardTiles;			// Tiles of 'parsedBoard', owned by the parser
 	std::vector<GridAction> gridActions;		// List of grid actions to be applied
 
-	// Helper function to locate every guaranteed mine in the current parsed board,
-	// with no duplicates.
-	std::unordered_set<Coord, CoordHash> findMines();
+	BitBoard bitboard;					// Bit plane copy of the parsed board used by solveStep() and guessStep().
+	std::vector<uint64_t> mineBits;		// Guaranteed mines found by solveStep(), one bit per cell.
+	std::vector<uint64_t> safeBits;		// Guaranteed safe cells found by solveStep(), one bit per cell.
+
+	std::vector<Coord> forcedCells;		// Scratch list for converting 'mineBits' and 'safeBits' into grid actions.
 
-	// Helper function to locate every guaranteed safe cell in the current parsed board,
-	// with no duplicates.
-	std::unordered_set<Coord, CoordHash> findSafeCells();
+	// Helper function to append one grid action of the given type
+	// for every cell set in a BitBoard plane.
+	void bitsToActions(const std::vector<uint64_t>& bits, ActionType type);
 
 	std::vector<Coord> frontierCells;		// List of coordinates of every unknown cell adjacent to a number cell.
 	std::vector<Constraint> constraints;	// Stores all constraints extracted from the current board.
@@ -66,12 +137,14 @@ private:
 	std::vector<int> mines;
 	std::vector<int> safeCells;
 
-	// Finds all unknown cells that are adjacent to a number
-	// cell and stores them in the 'frontierCells' vector.
+	std::vector<int> frontierIndex;			// Index in 'frontierCells' of every cell, row-major; -1 if not on the frontier.
+
+	// Finds all unknown cells that are adjacent to a number cell and stores
+	// them in the 'frontierCells' vector, reading only each tile's frontier list.
 	void collectFrontier();
 
-	// Finds all constraints in the current board and stores
-	// them in the 'constraints' vector.
+	// Finds all constraints in the current board and stores them in the
+	// 'constraints' vector, reading only each tile's list of number cells.
 	void collectConstraints();
 
 	// DFS to turn the frontier into independent sections saved as sect IDs in 'sect'
@@ -79,7 +152,18 @@ private:
 
 	bool checkAssignment(const std::vector<int>& assignment, const std::vector<int>& vars, std::vector<Constraint> cons);
 
-	void solveSections();
+	void solveSections(std::chrono::steady_clock::time_point deadline);
+
+	std::vector<SectionCache> sectionCache;										// Sections solved on the last CSP turn.
+	std::unordered_map<Coord, std::pair<int, int>, CoordHash> cachedCellBits;	// Cached section index and bit of each cell in 'sectionCache'.
+	std::vector<SectionProgress> pendingSections;								// Sections put aside at the last CSP turn's deadline.
+
+	// Tries to derive a section's valid assignments from the cached section holding
+	// all of its cells, checking only the constraints that cached section never saw.
+	// Fails, leaving a full enumeration to the caller, if the section gained cells,
+	// or if a cell it lost is still unknown.
+	bool filterCachedSection(const std::vector<int>& vars, const std::vector<Constraint>& cons,
+		const std::unordered_map<int, int>& globalToLocal, std::vector<uint32_t>& solutions);
 
 	void CSPGridActions();
 };
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "TurnScheduler.h"
+
+TurnScheduler::TurnScheduler() : budget(std::chrono::milliseconds(100)), guess(true) {}
+
+void TurnScheduler::run(Solver& solver) const {
+	auto deadline = std::chrono::steady_clock::now() + budget;
+
+	// The rules and the pattern table take microseconds, so they always run.
+	solver.solveStep();
+	if (solver.progress)
+		return;
+
+	solver.patternStep();
+	if (solver.progress)
+		return;
+
+	solver.CSPTurn(deadline);
+	if (solver.progress || !guess)
+		return;
+
+	solver.guessStep(deadline);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include "Solver.h"
+
+// Runs the solver's tiers on one turn, cheapest first, until one of them makes
+// progress: the single-cell rules, the pattern table, constraint satisfaction,
+// and finally a guess. Every turn gets the same time budget. Constraint
+// satisfaction keeps the moves of the sections it finishes in time and puts
+// the others aside to resume next turn, without guessing in the meantime. The
+// guess looks ahead for whatever time is left. A turn takes little more than
+// the budget however big its sections are.
+//
+// All of a turn's moves come from the tier that ran last, which is left in
+// Solver::tier; Solver::timedOut tells whether that tier hit the deadline.
+class TurnScheduler {
+public:
+	// Constructor; sets a 100 ms budget with guessing on.
+	TurnScheduler();
+
+	// Runs the tiers on the board last passed to solver.update(). Without
+	// 'guess', 'solver.progress' is left false when nothing is certain.
+	void run(Solver& solver) const;
+
+	std::chrono::microseconds budget;	// Time a turn may spend solving.
+	bool guess;							// Whether to guess when no move is certain.
+};